@@ -0,0 +1,93 @@
+/* Measure the I2C bus cost of each public RTC_DS3231 method
+ *
+ * Every call is repeated a number of times and the average duration is
+ * printed, together with the equivalent number of bytes clocked on the bus.
+ * With the bus running at 100 kHz, each byte (8 bits + ACK) takes 90 us, and
+ * each transaction adds an address byte plus the start/stop conditions.
+ * Running this sketch before and after a change to the driver shows whether
+ * it added or removed bus round trips. Without hardware, the chip models of
+ * extras/host count the transactions of every call: see `make buscost` there.
+ *
+ * VCC and GND of RTC should be connected to some power source
+ * SDA, SCL of RTC should be connected to SDA, SCL of arduino
+ *
+ * The sketch changes the alarm and square wave settings of the RTC; it
+ * leaves both alarms disabled and the square wave off. Measuring adjust()
+ * rewrites the current time, which may lose a fraction of a second.
+ */
+
+#include <RTClib.h>
+
+RTC_DS3231 rtc;
+
+// Number of calls averaged for each method
+const uint8_t REPEAT = 50;
+
+// Duration of one byte on the bus, in microseconds, at 100 kHz
+const float BYTE_MICROS = 90.0;
+
+// Prevents the compiler from optimizing away the measured calls
+volatile uint32_t sink;
+
+void report(const char *name, uint32_t elapsedMicros) {
+  float perCall = (float)elapsedMicros / REPEAT;
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(perCall, 1);
+  Serial.print(" us/call, ~");
+  Serial.print(perCall / BYTE_MICROS, 1);
+  Serial.println(" byte times");
+}
+
+// Time REPEAT executions of a statement and report the average.
+#define MEASURE(name, statement)                                               \
+  do {                                                                         \
+    uint32_t start = micros();                                                 \
+    for (uint8_t i = 0; i < REPEAT; i++) {                                     \
+      statement;                                                               \
+    }                                                                          \
+    report(name, micros() - start);                                            \
+  } while (0)
+
+void setup() {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  if (!rtc.begin()) {
+    Serial.println("Couldn't find RTC");
+    Serial.flush();
+    while (1) delay(10);
+  }
+
+  // Uncomment to measure the methods with the register cache enabled
+  // rtc.enableRegisterCache();
+
+  DateTime now = rtc.now();
+
+  Serial.println("RTC_DS3231 bus cost per call");
+  MEASURE("now()", sink = rtc.now().second());
+  MEASURE("adjust()", rtc.adjust(now));
+  MEASURE("lostPower()", sink = rtc.lostPower());
+  MEASURE("getTemperature()", sink = rtc.getTemperature());
+  MEASURE("readSqwPinMode()", sink = rtc.readSqwPinMode());
+  MEASURE("writeSqwPinMode()", rtc.writeSqwPinMode(DS3231_OFF));
+  MEASURE("setAlarm1()", rtc.setAlarm1(now, DS3231_A1_Hour));
+  MEASURE("setAlarm2()", rtc.setAlarm2(now, DS3231_A2_Hour));
+  MEASURE("getAlarm1()", sink = rtc.getAlarm1().second());
+  MEASURE("getAlarm1Mode()", sink = rtc.getAlarm1Mode());
+  MEASURE("alarmFired()", sink = rtc.alarmFired(1));
+  MEASURE("clearAlarm()", rtc.clearAlarm(1));
+  MEASURE("disableAlarm()", rtc.disableAlarm(1));
+  MEASURE("enable32K()", rtc.enable32K());
+  MEASURE("disable32K()", rtc.disable32K());
+  MEASURE("isEnabled32K()", sink = rtc.isEnabled32K());
+  MEASURE("getSnapshot()", sink = rtc.getSnapshot().now.second());
+
+  rtc.disableAlarm(2);
+  rtc.clearAlarm(2);
+}
+
+void loop() {}
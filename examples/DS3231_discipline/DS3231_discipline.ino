@@ -0,0 +1,39 @@
+// Software clock based on micros(), kept in step with a DS3231
+
+#include "RTClib.h"
+
+RTC_DS3231 rtc;
+RTC_Micros softClock;
+RTC_Discipline<RTC_DS3231> discipline(rtc, softClock, 60); // update every minute
+
+void setup () {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  if (! rtc.begin()) {
+    Serial.println("Couldn't find RTC");
+    Serial.flush();
+    while (1) delay(10);
+  }
+
+  // sets the software clock from the RTC
+  discipline.update();
+}
+
+void loop () {
+  if (discipline.poll()) {
+    Serial.print("Offset: ");
+    Serial.print(discipline.offset());
+    Serial.print(" us, correction: ");
+    Serial.print(discipline.frequency(), 3);
+    Serial.println(discipline.locked() ? " ppm" : " ppm (not locked yet)");
+  }
+
+  // reading the software clock involves no I2C traffic
+  softClock.nowPrecise().preciseTimestamp(Serial);
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,82 @@
+/* Many alarms multiplexed onto alarm 1 of a DS3231
+ *
+ * VCC and GND of RTC should be connected to some power source
+ * SDA, SCL of RTC should be connected to SDA, SCL of arduino
+ * SQW should be connected to CLOCK_INTERRUPT_PIN
+ * CLOCK_INTERRUPT_PIN needs to work with interrupts
+ */
+
+#include <RTClib.h>
+
+RTC_DS3231 rtc;
+
+AlarmScheduler::Entry entries[8];
+AlarmScheduler scheduler(rtc, entries, 8);
+
+// the pin that is connected to SQW
+#define CLOCK_INTERRUPT_PIN 2
+
+// alarm identifiers
+enum { BLINK, REPORT, ONCE };
+
+volatile bool alarmSignaled = false;
+
+void onAlarm() {
+    alarmSignaled = true;
+}
+
+void setup() {
+    Serial.begin(9600);
+
+    if(!rtc.begin()) {
+        Serial.println("Couldn't find RTC!");
+        Serial.flush();
+        while (1) delay(10);
+    }
+
+    if(rtc.lostPower()) {
+        // this will adjust to the date and time at compilation
+        rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+    }
+
+    rtc.disable32K();
+    rtc.disableAlarm(2);
+
+    pinMode(LED_BUILTIN, OUTPUT);
+    pinMode(CLOCK_INTERRUPT_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(CLOCK_INTERRUPT_PIN), onAlarm, FALLING);
+
+    // takes over alarm 1 and the SQW pin
+    scheduler.begin();
+
+    DateTime now = rtc.now();
+    scheduler.add(BLINK, now + TimeSpan(2), 2);   // every 2 seconds
+    scheduler.add(REPORT, now + TimeSpan(15), 15); // every 15 seconds
+    scheduler.add(ONCE, now + TimeSpan(40));       // once
+}
+
+void loop() {
+    if (!alarmSignaled) {
+        return; // a sleeping MCU would be woken up by the interrupt
+    }
+    alarmSignaled = false;
+
+    uint8_t id;
+    while (scheduler.poll(id)) {
+        switch (id) {
+          case BLINK:
+            digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+            break;
+          case REPORT:
+            rtc.now().timestamp(Serial);
+            Serial.print(" - ");
+            Serial.print(scheduler.count());
+            Serial.println(" alarms scheduled");
+            break;
+          case ONCE:
+            Serial.println("One-shot alarm, stopping the blinking");
+            scheduler.remove(BLINK);
+            break;
+        }
+    }
+}
@@ -0,0 +1,230 @@
+// Measure the execution time of the date and time calculations.
+//
+// The results are printed as nanoseconds per operation, CPU cycles per
+// operation and operations per second. Run it before and after changing the
+// date math in order to catch performance regressions on the target board.
+//
+// The sketch also runs on a Linux host, see extras/host:
+//   make -C extras/host benchmark
+
+#include "RTClib.h"
+
+// Prevents the compiler from optimizing away the benchmarked calls.
+volatile uint32_t sink;
+
+// Sample dates spread over the supported range, filled in by setup().
+const uint8_t SAMPLES = 32;
+DateTime samples[SAMPLES];
+
+// Number of passes over the samples for each benchmark.
+#ifndef BENCHMARK_PASSES
+#define BENCHMARK_PASSES 100
+#endif
+const uint16_t PASSES = BENCHMARK_PASSES;
+
+// Print the results of a benchmark run.
+void report(const char *name, uint32_t elapsedMicros, uint32_t count) {
+  float nsPerOp = elapsedMicros * 1000.0 / count;
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(nsPerOp, 1);
+  Serial.print(" ns/op, ");
+#ifdef F_CPU
+  Serial.print(nsPerOp * (F_CPU / 1e9), 1);
+  Serial.print(" cycles/op, ");
+#endif
+  Serial.print(1e9 / nsPerOp, 0);
+  Serial.println(" ops/s");
+}
+
+// DateTime(uint32_t) over the whole supported range, 2000--2099. The step
+// is a day plus a few seconds, so that every time of the day gets sampled.
+void benchFromUnixtime() {
+  const uint32_t first = SECONDS_FROM_1970_TO_2000;
+  const uint32_t last = DateTime(2099, 12, 31, 23, 59, 59).unixtime();
+  const uint32_t step = SECONDS_PER_DAY + 7;
+  uint32_t count = 0;
+  uint32_t start = micros();
+  for (uint32_t t = first; t <= last; t += step) {
+    DateTime dt(t);
+    sink = dt.day();
+    count++;
+  }
+  report("DateTime(uint32_t)", micros() - start, count);
+
+  // Sanity check: the conversion must round-trip.
+  uint32_t errors = 0;
+  for (uint32_t t = first; t <= last; t += step) {
+    if (DateTime(t).unixtime() != t)
+      errors++;
+  }
+  Serial.print("  round-trip errors: ");
+  Serial.println(errors);
+}
+
+void benchUnixtime() {
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = samples[i].unixtime();
+  report("unixtime()", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+void benchSecondstime() {
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = samples[i].secondstime();
+  report("secondstime()", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+void benchDayOfTheWeek() {
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = samples[i].dayOfTheWeek();
+  report("dayOfTheWeek()", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+void benchIsValid() {
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = samples[i].isValid();
+  report("isValid()", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+void benchToString() {
+  char buffer[32];
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++) {
+    for (uint8_t i = 0; i < SAMPLES; i++) {
+      strcpy(buffer, "DDD, DD MMM YYYY hh:mm:ss");
+      sink = samples[i].toString(buffer)[0];
+    }
+  }
+  report("toString()", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+void benchFormat() {
+  DateTimeFormat format("DDD, DD MMM YYYY hh:mm:ss");
+  char buffer[32];
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = format.format(samples[i], buffer)[0];
+  report("DateTimeFormat::format()", micros() - start,
+         (uint32_t)PASSES * SAMPLES);
+}
+
+void benchTimestamp() {
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = samples[i].timestamp().length();
+  report("timestamp()", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+void benchTimestampBuffer() {
+  char buffer[TIMESTAMP_BUFFER_SIZE];
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = samples[i].timestamp(buffer);
+  report("timestamp(char *)", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+// A log with one record every 10 seconds, exported 16 records at a time.
+void benchTimestampBatch() {
+  const uint8_t CHUNK = 16;
+  uint32_t times[CHUNK];
+  char buffer[CHUNK * TIMESTAMP_RECORD_SIZE];
+  TimestampFormatter formatter;
+  uint32_t t = samples[0].unixtime();
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++) {
+    for (uint8_t i = 0; i < CHUNK; i++, t += 10)
+      times[i] = t;
+    sink = formatter.format(times, CHUNK, buffer);
+  }
+  report("TimestampFormatter", micros() - start, (uint32_t)PASSES * CHUNK);
+}
+
+void benchFromIso8601() {
+  char buffer[SAMPLES][20];
+  for (uint8_t i = 0; i < SAMPLES; i++)
+    strcpy(buffer[i], samples[i].timestamp().c_str());
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = DateTime(buffer[i]).second();
+  report("DateTime(iso8601)", micros() - start, (uint32_t)PASSES * SAMPLES);
+
+  start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = parseIso8601(buffer[i]).time.second();
+  report("parseIso8601()", micros() - start, (uint32_t)PASSES * SAMPLES);
+}
+
+void benchCompare() {
+  uint32_t start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 1; i < SAMPLES; i++)
+      sink = samples[i - 1] < samples[i];
+  report("operator<", micros() - start, (uint32_t)PASSES * (SAMPLES - 1));
+
+  start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 1; i < SAMPLES; i++)
+      sink = samples[i - 1] == samples[i];
+  report("operator==", micros() - start, (uint32_t)PASSES * (SAMPLES - 1));
+
+  PackedDateTime packed[SAMPLES];
+  for (uint8_t i = 0; i < SAMPLES; i++)
+    packed[i] = PackedDateTime(samples[i]);
+  start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 1; i < SAMPLES; i++)
+      sink = packed[i - 1] < packed[i];
+  report("PackedDateTime <", micros() - start,
+         (uint32_t)PASSES * (SAMPLES - 1));
+
+  start = micros();
+  for (uint16_t pass = 0; pass < PASSES; pass++)
+    for (uint8_t i = 0; i < SAMPLES; i++)
+      sink = PackedDateTime(samples[i]).raw();
+  report("PackedDateTime(DateTime)", micros() - start,
+         (uint32_t)PASSES * SAMPLES);
+}
+
+void setup() {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  // Pseudo-random, but reproducible, sample dates.
+  uint32_t t = SECONDS_FROM_1970_TO_2000;
+  for (uint8_t i = 0; i < SAMPLES; i++) {
+    t += 97000000UL - 2468 * i;
+    samples[i] = DateTime(t);
+  }
+
+  Serial.println("RTClib benchmark");
+  benchFromUnixtime();
+  benchUnixtime();
+  benchSecondstime();
+  benchDayOfTheWeek();
+  benchIsValid();
+  benchToString();
+  benchFormat();
+  benchTimestamp();
+  benchTimestampBuffer();
+  benchTimestampBatch();
+  benchFromIso8601();
+  benchCompare();
+}
+
+void loop() {}
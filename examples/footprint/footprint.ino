@@ -0,0 +1,144 @@
+/* Flash and RAM footprint of the RTClib APIs
+ *
+ * Each block below uses one API of the library, on values the compiler
+ * cannot predict, and stores a result in a volatile variable so that the
+ * code is not optimized away. Compiled as is, the sketch uses every API.
+ *
+ * extras/footprint.sh compiles it once with -DFOOTPRINT_ONLY alone, as a
+ * baseline, then once per API with -DFOOTPRINT_ONLY -DFOOTPRINT_<API>, and
+ * reports how much flash and RAM each API adds to the baseline.
+ */
+
+#include <RTClib.h>
+
+#ifndef FOOTPRINT_ONLY // no API selected: use them all
+#define FOOTPRINT_DATETIME
+#define FOOTPRINT_FLASH_STRING
+#define FOOTPRINT_TIMESPAN
+#define FOOTPRINT_TOSTRING
+#define FOOTPRINT_TIMESTAMP
+#define FOOTPRINT_TIMESTAMP_STRING
+#define FOOTPRINT_DATETIMEFORMAT
+#define FOOTPRINT_ISO8601
+#define FOOTPRINT_DATETIME64
+#define FOOTPRINT_TIMEZONE
+#define FOOTPRINT_CRON
+#define FOOTPRINT_DS1307
+#define FOOTPRINT_DS3231
+#define FOOTPRINT_PCF8523
+#define FOOTPRINT_PCF8563
+#define FOOTPRINT_MILLIS
+#define FOOTPRINT_MICROS
+#endif
+
+volatile uint32_t input = 1700000000; // not known at compile time
+volatile uint32_t sink;               // keeps the results alive
+
+void setup() {
+#ifdef FOOTPRINT_DATETIME
+  DateTime dt(input);
+  sink = DateTime(dt.year(), dt.month(), dt.day(), 12, 0, 0).unixtime() +
+         dt.dayOfTheWeek();
+#else
+  DateTime dt;
+#endif
+
+#ifdef FOOTPRINT_FLASH_STRING
+  DateTime compiled(F(__DATE__), F(__TIME__));
+  sink = compiled.unixtime();
+#endif
+
+#ifdef FOOTPRINT_TIMESPAN
+  sink = (dt + TimeSpan(input) - TimeSpan(1, 2, 3, 4)).unixtime();
+#endif
+
+#ifdef FOOTPRINT_TOSTRING
+  char formatted[] = "DDD, DD MMM YYYY hh:mm:ss AP";
+  sink = dt.toString(formatted)[0];
+#endif
+
+#ifdef FOOTPRINT_TIMESTAMP
+  char stamp[TIMESTAMP_BUFFER_SIZE];
+  sink = dt.timestamp(stamp);
+#endif
+
+#if defined(FOOTPRINT_TIMESTAMP_STRING) && !defined(RTCLIB_NO_STRING)
+  sink = dt.timestamp().length();
+#endif
+
+#ifdef FOOTPRINT_DATETIMEFORMAT
+  DateTimeFormat format("YYYY-MM-DD hh:mm");
+  char line[20];
+  sink = format.format(dt, line)[0];
+#endif
+
+#if defined(FOOTPRINT_ISO8601) && !defined(RTCLIB_NO_ISO8601)
+  char iso[] = "2024-01-02T03:04:05Z";
+  iso[3] = '0' + input % 10;
+  sink = parseIso8601(iso).time.unixtime();
+#endif
+
+#ifdef FOOTPRINT_DATETIME64
+  sink = DateTime64(dt).unixtime();
+#endif
+
+#ifdef FOOTPRINT_TIMEZONE
+  TimeZone zone;
+  zone.begin("CET-1CEST,M3.5.0,M10.5.0/3");
+  sink = zone.toLocal(dt).unixtime();
+#endif
+
+#ifdef FOOTPRINT_CRON
+  CronSchedule schedule;
+  DateTime next;
+  schedule.begin("*/5 * * * *");
+  schedule.next(dt, next);
+  sink = next.unixtime();
+#endif
+
+#ifdef FOOTPRINT_DS1307
+  RTC_DS1307 ds1307;
+  ds1307.begin();
+  if (ds1307.lostPower())
+    ds1307.adjust(dt);
+  sink = ds1307.now().unixtime();
+#endif
+
+#ifdef FOOTPRINT_DS3231
+  RTC_DS3231 ds3231;
+  ds3231.begin();
+  if (ds3231.lostPower())
+    ds3231.adjust(dt);
+  sink = ds3231.now().unixtime();
+#endif
+
+#ifdef FOOTPRINT_PCF8523
+  RTC_PCF8523 pcf8523;
+  pcf8523.begin();
+  if (pcf8523.lostPower())
+    pcf8523.adjust(dt);
+  sink = pcf8523.now().unixtime();
+#endif
+
+#ifdef FOOTPRINT_PCF8563
+  RTC_PCF8563 pcf8563;
+  pcf8563.begin();
+  if (pcf8563.lostPower())
+    pcf8563.adjust(dt);
+  sink = pcf8563.now().unixtime();
+#endif
+
+#ifdef FOOTPRINT_MILLIS
+  RTC_Millis softMillis;
+  softMillis.begin(dt);
+  sink = softMillis.now().unixtime();
+#endif
+
+#ifdef FOOTPRINT_MICROS
+  RTC_Micros softMicros;
+  softMicros.begin(dt);
+  sink = softMicros.now().unixtime();
+#endif
+}
+
+void loop() {}
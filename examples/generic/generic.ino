@@ -0,0 +1,67 @@
+/* Chip-generic code with RTC_Interface
+ *
+ * logStatus() is written once, and works with every RTC class of the
+ * library. Each call compiles down to direct calls to the actual class:
+ * there is no virtual table. The features an RTC lacks simply report
+ * false, and RTC_Traits tells which ones are available at compile time.
+ *
+ * VCC and GND of RTC should be connected to some power source
+ * SDA, SCL of RTC should be connected to SDA, SCL of arduino
+ */
+
+#include <RTClib.h>
+
+RTC_DS3231 rtc;
+RTC_Millis softRtc;
+
+template <class RTC> void logStatus(const char *name, RTC_Interface<RTC> &clk) {
+  Serial.print(name);
+  Serial.print(": ");
+  if (clk.lostPower()) {
+    Serial.println("lost power");
+    return;
+  }
+
+  char buffer[] = "YYYY-MM-DD hh:mm:ss";
+  Serial.print(clk.now().toString(buffer));
+
+  float celsius;
+  if (clk.readTemperature(celsius)) {
+    Serial.print(", ");
+    Serial.print(celsius);
+    Serial.print(" C");
+  }
+
+  if (RTC_Traits<RTC>::hasNvram) {
+    Serial.print(", ");
+    Serial.print(RTC_Traits<RTC>::nvramSize);
+    Serial.print(" bytes of NVRAM");
+  }
+  Serial.println();
+}
+
+void setup() {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  if (!rtc.begin()) {
+    Serial.println("Couldn't find RTC");
+    Serial.flush();
+    while (1) delay(10);
+  }
+
+  if (rtc.lostPower()) {
+    // this will adjust to the date and time at compilation
+    rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+  }
+  softRtc.begin(rtc.now());
+}
+
+void loop() {
+  logStatus("DS3231", rtc);
+  logStatus("millis", softRtc);
+  delay(3000);
+}
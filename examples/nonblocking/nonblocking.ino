@@ -0,0 +1,67 @@
+/* Reading the time of a DS3231 without blocking
+ *
+ * requestNow() starts reading the time, and each call to pollNow() makes
+ * one short I2C transaction until the time is complete. The rest of the
+ * loop keeps running in between: here it blinks the built-in LED.
+ *
+ * The number of bytes read per transaction is set by RTC_TRANSFER_CHUNK,
+ * which can be overridden with a compiler flag (e.g. -DRTC_TRANSFER_CHUNK=4).
+ * Setting the time with requestAdjust() and pollAdjust() is not split: it
+ * is written in a single transaction, so that it cannot tear.
+ *
+ * VCC and GND of RTC should be connected to some power source
+ * SDA, SCL of RTC should be connected to SDA, SCL of arduino
+ */
+
+#include <RTClib.h>
+
+RTC_DS3231 rtc;
+
+uint32_t lastRequest = 0;
+uint32_t lastBlink = 0;
+
+void setup() {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  if (!rtc.begin()) {
+    Serial.println("Couldn't find RTC");
+    Serial.flush();
+    while (1) delay(10);
+  }
+
+  if (rtc.lostPower()) {
+    // this will adjust to the date and time at compilation, without
+    // blocking for the whole transfer
+    rtc.requestAdjust(DateTime(F(__DATE__), F(__TIME__)));
+    while (!rtc.pollAdjust()) {
+      // other work could be done here
+    }
+  }
+
+  pinMode(LED_BUILTIN, OUTPUT);
+}
+
+void loop() {
+  // start a new reading once per second
+  if (millis() - lastRequest >= 1000) {
+    lastRequest = millis();
+    rtc.requestNow();
+  }
+
+  // make progress on the reading, if one is in progress
+  DateTime now;
+  if (rtc.pollNow(now)) {
+    char buffer[] = "YYYY-MM-DD hh:mm:ss";
+    Serial.println(now.toString(buffer));
+  }
+
+  // the loop never waits for the RTC
+  if (millis() - lastBlink >= 250) {
+    lastBlink = millis();
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  }
+}
@@ -0,0 +1,65 @@
+/* Redundant RTCs: a DS3231 and a PCF8563 voting with RTC_Millis
+ *
+ * RTC_Redundant reads the members until a majority of them agree, and
+ * returns the median of their times. A member that lost power or drifted
+ * away is set back to the consensus time.
+ *
+ * With only two hardware RTCs, the software clock breaks the ties: it is
+ * set from the first consensus, then keeps time from millis().
+ *
+ * VCC and GND of the RTCs should be connected to some power source
+ * SDA, SCL of the RTCs should be connected to SDA, SCL of arduino
+ */
+
+#include <RTClib.h>
+
+RTC_DS3231 ds3231;
+RTC_PCF8563 pcf8563;
+RTC_Millis softRtc;
+RTC_Redundant redundant;
+
+void setup() {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  if (!ds3231.begin() || !pcf8563.begin()) {
+    Serial.println("Couldn't find both RTCs");
+    Serial.flush();
+    while (1) delay(10);
+  }
+
+  redundant.add(ds3231);
+  redundant.add(pcf8563);
+  redundant.add(softRtc);
+
+  if (ds3231.lostPower() && pcf8563.lostPower()) {
+    // this will adjust all the clocks to the date and time at compilation
+    redundant.adjust(DateTime(F(__DATE__), F(__TIME__)));
+  } else {
+    // start the software clock from whichever RTC kept its time
+    softRtc.begin(ds3231.lostPower() ? pcf8563.now() : ds3231.now());
+  }
+}
+
+void loop() {
+  DateTime now = redundant.now();
+
+  char buffer[] = "YYYY-MM-DD hh:mm:ss";
+  Serial.print(now.toString(buffer));
+  Serial.print(" agreed by ");
+  Serial.print(redundant.confidence());
+  Serial.print(" of ");
+  Serial.print(redundant.size());
+  if (redundant.confidence() < redundant.majority())
+    Serial.print(" (no majority!)");
+  if (redundant.faults()) {
+    Serial.print(", faults: 0x");
+    Serial.print(redundant.faults(), HEX);
+  }
+  Serial.println();
+
+  delay(3000);
+}
@@ -0,0 +1,60 @@
+/* Millisecond timestamps from the 1 Hz square wave of a DS3231
+ *
+ * The DS3231 outputs a 1 Hz square wave on its SQW pin. An interrupt
+ * handler latches micros() on each edge, which lets RTC_SqwClock return
+ * the time with sub-second resolution and without any I2C traffic.
+ *
+ * VCC and GND of RTC should be connected to some power source
+ * SDA, SCL of RTC should be connected to SDA, SCL of arduino
+ * SQW should be connected to SQW_PIN, which needs to work with interrupts
+ */
+
+#include <RTClib.h>
+
+RTC_DS3231 rtc;
+RTC_SqwClock sqwClock;
+
+// the pin that is connected to SQW
+#define SQW_PIN 2
+
+void onTick() { sqwClock.tick(); }
+
+void setup() {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  if (!rtc.begin()) {
+    Serial.println("Couldn't find RTC");
+    Serial.flush();
+    while (1) delay(10);
+  }
+
+  if (rtc.lostPower()) {
+    // this will adjust to the date and time at compilation
+    rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+  }
+
+  // The SQW pin is open drain: it needs a pull-up
+  pinMode(SQW_PIN, INPUT_PULLUP);
+  rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
+
+  // Attach to the edge on which the RTC increments its seconds
+  attachInterrupt(digitalPinToInterrupt(SQW_PIN), onTick, FALLING);
+
+  if (!sqwClock.begin(rtc)) {
+    Serial.println("No signal on the SQW pin");
+    Serial.flush();
+    while (1) delay(10);
+  }
+}
+
+void loop() {
+  // e.g. 2024-06-01T12:34:56.789
+  sqwClock.nowPrecise().preciseTimestamp(Serial);
+  Serial.println();
+
+  delay(337);
+}
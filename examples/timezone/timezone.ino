@@ -0,0 +1,38 @@
+// Local time from an RTC kept on UTC, using POSIX time zone rules
+
+#include "RTClib.h"
+
+RTC_Millis rtc;
+TimeZone tz;
+
+void setup () {
+  Serial.begin(57600);
+
+#ifndef ESP8266
+  while (!Serial); // wait for serial port to connect. Needed for native USB
+#endif
+
+  // Central European Time: UTC+1, with DST from the last Sunday of March at
+  // 02:00 to the last Sunday of October at 03:00 local time
+  if (!tz.begin("CET-1CEST,M3.5.0,M10.5.0/3")) {
+    Serial.println("Invalid TZ string");
+    Serial.flush();
+    while (1) delay(10);
+  }
+
+  // Shortly before the end of DST, in UTC
+  rtc.begin(DateTime(2023, 10, 29, 0, 59, 50));
+}
+
+void loop () {
+  DateTime utc = rtc.now();
+  DateTime local = tz.toLocal(utc);
+
+  utc.timestamp(Serial, DateTime::TIMESTAMP_FULL, 0);
+  Serial.print(" = ");
+  local.timestamp(Serial, DateTime::TIMESTAMP_FULL, tz.offset(utc));
+  Serial.print(' ');
+  Serial.println(tz.abbreviation(utc));
+
+  delay(3000);
+}
@@ -0,0 +1,119 @@
+#!/bin/bash
+#
+# Report the flash and RAM footprint of each RTClib API.
+#
+# usage: extras/footprint.sh [-v] [-b fqbn | -H] [compiler flags...]
+#
+# Compiles examples/footprint once as a baseline, then once per API, and
+# prints a Markdown table of the flash and RAM each API adds. The last rows
+# give the footprint of the sketch using every API, then what each feature
+# switch saves on it. With -v, the symbols each API adds or grows are listed
+# as well, on stderr. The compiler flags, e.g. -DRTCLIB_NO_12H, apply to
+# both the sketch and the library.
+#
+# Requires arduino-cli, with the core of the board (arduino:avr:uno by
+# default) and Adafruit BusIO installed. The binutils of the core are found
+# automatically; set NM and SIZE to override them.
+#
+# With -H, the sketch is compiled for the host instead, with g++ -Os and the
+# Arduino core of extras/host. The sizes are those of x86-64 code, larger
+# than on AVR, but they compare the APIs and switches without arduino-cli.
+
+set -e
+
+FQBN=arduino:avr:uno
+VERBOSE=
+HOST=
+while [ $# -gt 0 ]; do
+  case $1 in
+  -v) VERBOSE=1 && shift ;;
+  -b) FQBN=$2 && shift 2 ;;
+  -H) HOST=1 && shift ;;
+  *) break ;;
+  esac
+done
+FLAGS="$*"
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+SKETCH=$ROOT/examples/footprint
+APIS="DATETIME FLASH_STRING TIMESPAN TOSTRING TIMESTAMP TIMESTAMP_STRING
+      DATETIMEFORMAT ISO8601 DATETIME64 TIMEZONE CRON DS1307 DS3231 PCF8523
+      PCF8563 MILLIS MICROS"
+SWITCHES="RTCLIB_NO_STRING RTCLIB_NO_12H RTCLIB_NO_ISO8601"
+
+if [ -n "$HOST" ]; then
+  FQBN="the host ($(uname -m))"
+  NM=${NM:-nm}
+  SIZE=${SIZE:-size}
+else
+  TOOLS=$(ls -d "$HOME"/.arduino15/packages/arduino/tools/avr-gcc/*/bin \
+    2>/dev/null | tail -n 1)
+  NM=${NM:-${TOOLS:+$TOOLS/}avr-nm}
+  SIZE=${SIZE:-${TOOLS:+$TOOLS/}avr-size}
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# build <name> <flags>: compile the sketch, leave the ELF in $WORK/<name>.elf
+build() {
+  if [ -n "$HOST" ]; then
+    HOSTDIR=$ROOT/extras/host
+    # shellcheck disable=SC2086 # the flags are split on purpose
+    ${CXX:-g++} -Os -ffunction-sections -fdata-sections -Wl,--gc-sections \
+      -I"$HOSTDIR" -I"$ROOT/src" -DSKETCH="\"$SKETCH/footprint.ino\"" $2 \
+      -o "$WORK/$1.elf" "$HOSTDIR/sketch.cpp" "$ROOT"/src/*.cpp \
+      "$HOSTDIR/host.cpp" "$HOSTDIR/Adafruit_I2CDevice.cpp" \
+      "$HOSTDIR/RTCModels.cpp"
+    return
+  fi
+  arduino-cli compile --fqbn "$FQBN" --library "$ROOT" \
+    --build-property "compiler.cpp.extra_flags=$2" \
+    --output-dir "$WORK/$1" "$SKETCH" >/dev/null
+  mv "$WORK/$1/footprint.ino.elf" "$WORK/$1.elf"
+}
+
+# footprint <name>: print "flash ram" of a build
+footprint() {
+  "$SIZE" "$WORK/$1.elf" | awk 'NR == 2 { print $1 + $2, $2 + $3 }'
+}
+
+# symbols <name>: list "type size name" of the symbols of a build
+symbols() {
+  "$NM" -C -S "$WORK/$1.elf" |
+    awk 'NF >= 4 { t = $3; $1 = $3 = ""; sub(/^ +/, ""); print t, $0 }' |
+    sort
+}
+
+build baseline "-DFOOTPRINT_ONLY $FLAGS"
+read -r BASE_FLASH BASE_RAM <<<"$(footprint baseline)"
+symbols baseline >"$WORK/baseline.sym"
+
+echo "Footprint on $FQBN${FLAGS:+ with $FLAGS}"
+echo
+echo "| API | Flash (bytes) | RAM (bytes) |"
+echo "| --- | ---: | ---: |"
+echo "| baseline (empty sketch) | $BASE_FLASH | $BASE_RAM |"
+for api in $APIS; do
+  build "$api" "-DFOOTPRINT_ONLY -DFOOTPRINT_$api $FLAGS"
+  read -r FLASH RAM <<<"$(footprint "$api")"
+  echo "| $api | +$((FLASH - BASE_FLASH)) | +$((RAM - BASE_RAM)) |"
+  if [ -n "$VERBOSE" ]; then
+    symbols "$api" >"$WORK/$api.sym"
+    echo "$api:" >&2
+    # Symbols not in the baseline, largest first, sizes in decimal
+    comm -13 "$WORK/baseline.sym" "$WORK/$api.sym" |
+      while read -r type size name; do
+        echo "$((16#$size)) $type $name"
+      done | sort -rn | sed 's/^/    /' >&2
+  fi
+done
+
+build all "$FLAGS"
+read -r ALL_FLASH ALL_RAM <<<"$(footprint all)"
+echo "| every API | +$((ALL_FLASH - BASE_FLASH)) | +$((ALL_RAM - BASE_RAM)) |"
+for switch in $SWITCHES; do
+  build "$switch" "-D$switch $FLAGS"
+  read -r FLASH RAM <<<"$(footprint "$switch")"
+  echo "| every API, \`$switch\` | $((FLASH - ALL_FLASH)) | $((RAM - ALL_RAM)) |"
+done
@@ -0,0 +1,90 @@
+/*
+  Stand-in for the Adafruit BusIO I2C device, see Adafruit_I2CDevice.h.
+*/
+
+#include "Adafruit_I2CDevice.h"
+#include "RTCModels.h"
+
+I2CCounters i2cCounters;
+bool i2cAdvancesClock = true;
+
+Adafruit_I2CDevice::Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire)
+    : _addr(addr), _wire(theWire), _begun(false) {}
+
+bool Adafruit_I2CDevice::begin(bool addr_detect) {
+  _wire->begin();
+  _begun = true;
+  return addr_detect ? detected() : true;
+}
+
+/** Count a transaction: START, address byte, data bytes and STOP */
+void Adafruit_I2CDevice::count(size_t bytes) {
+  // Each byte takes 9 clocks with its ACK, START and STOP one more each
+  uint32_t bits = 9 * (1 + bytes) + 2;
+  uint32_t us = (bits * 1000000ULL + _wire->frequency - 1) / _wire->frequency;
+  i2cCounters.transactions++;
+  i2cCounters.bytes += bytes;
+  i2cCounters.busMicros += us;
+  if (i2cAdvancesClock)
+    hostAdvanceClock(us);
+}
+
+bool Adafruit_I2CDevice::detected(void) {
+  count(0);
+  return RTCModel::find(_wire, _addr) != nullptr;
+}
+
+bool Adafruit_I2CDevice::read(uint8_t *buffer, size_t len, bool stop) {
+  RTCModel *model = RTCModel::find(_wire, _addr);
+  if (!model) {
+    count(0);
+    return false;
+  }
+  // Each chunk is a transaction
+  do {
+    size_t chunk = len < maxBufferSize() ? len : maxBufferSize();
+    model->start();
+    count(chunk);
+    for (size_t i = 0; i < chunk; i++)
+      *buffer++ = model->readByte();
+    len -= chunk;
+  } while (len);
+  return true;
+}
+
+bool Adafruit_I2CDevice::write(const uint8_t *buffer, size_t len, bool stop,
+                               const uint8_t *prefix_buffer,
+                               size_t prefix_len) {
+  if (len + prefix_len > maxBufferSize())
+    return false;
+  RTCModel *model = RTCModel::find(_wire, _addr);
+  if (!model) {
+    count(0);
+    return false;
+  }
+  model->start();
+  count(prefix_len + len);
+  // The first byte sets the register pointer, the others are written
+  for (size_t i = 0; i < prefix_len + len; i++) {
+    uint8_t value = i < prefix_len ? prefix_buffer[i] : buffer[i - prefix_len];
+    if (i == 0)
+      model->setPointer(value);
+    else
+      model->writeByte(value);
+  }
+  return true;
+}
+
+bool Adafruit_I2CDevice::write_then_read(const uint8_t *write_buffer,
+                                         size_t write_len,
+                                         uint8_t *read_buffer,
+                                         size_t read_len, bool stop) {
+  if (!write(write_buffer, write_len, stop))
+    return false;
+  return read(read_buffer, read_len);
+}
+
+bool Adafruit_I2CDevice::setSpeed(uint32_t desiredclk) {
+  _wire->setClock(desiredclk);
+  return true;
+}
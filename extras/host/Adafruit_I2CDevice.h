@@ -0,0 +1,67 @@
+/*
+  Stand-in for the Adafruit BusIO I2C device, for the host build. The
+  transfers go to the chip model attached to the same bus and address (see
+  RTCModels.h), and are counted in I2CCounters, so that the I2C cost of
+  every driver call can be measured. Without a model at the address, the
+  device does not acknowledge and every transfer fails.
+
+  Like BusIO on AVR, at most I2C_BUFFER_SIZE bytes are written per
+  transaction, and longer reads are split into several transactions.
+*/
+
+#ifndef HOST_ADAFRUIT_I2CDEVICE_H
+#define HOST_ADAFRUIT_I2CDEVICE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#ifndef I2C_BUFFER_SIZE
+#define I2C_BUFFER_SIZE 32 ///< Size of the Wire buffer, as on AVR
+#endif
+
+/** I2C traffic since the last reset() */
+struct I2CCounters {
+  uint32_t transactions; ///< Address phases: START and repeated START
+  uint32_t bytes;        ///< Data bytes, not counting the address bytes
+  uint32_t busMicros;    ///< Time the bus was busy, at the bus clock
+
+  /** Clear the counters */
+  void reset(void) { transactions = bytes = busMicros = 0; }
+};
+
+/** Counters of all the I2C traffic of the host build */
+extern I2CCounters i2cCounters;
+
+/**
+  Whether the time spent on the bus moves the virtual clock forward, as it
+  would on a board. Defaults to true.
+*/
+extern bool i2cAdvancesClock;
+
+/** I2C device with the interface of Adafruit BusIO */
+class Adafruit_I2CDevice {
+public:
+  Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire);
+  uint8_t address(void) { return _addr; }
+  bool begin(bool addr_detect = true);
+  void end(void) { _begun = false; }
+  bool detected(void);
+  bool read(uint8_t *buffer, size_t len, bool stop = true);
+  bool write(const uint8_t *buffer, size_t len, bool stop = true,
+             const uint8_t *prefix_buffer = nullptr, size_t prefix_len = 0);
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len,
+                       bool stop = false);
+  bool setSpeed(uint32_t desiredclk);
+  /** Maximum number of bytes in one transaction */
+  size_t maxBufferSize() { return I2C_BUFFER_SIZE; }
+
+private:
+  void count(size_t bytes);
+
+  uint8_t _addr;
+  TwoWire *_wire;
+  bool _begun;
+};
+
+#endif // HOST_ADAFRUIT_I2CDEVICE_H
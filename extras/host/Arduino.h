@@ -0,0 +1,146 @@
+/*
+  Minimal Arduino core, enough to build RTClib and some of its examples on
+  a Linux host. See Makefile.
+
+  micros() and millis() follow a virtual clock: it runs with the real
+  clock, but delay() returns at once and moves it forward instead, so that
+  sketches and tests run faster than real time. Tests can also freeze it.
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define PGM_P const char *
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+class __FlashStringHelper;
+#define F(string_literal)                                                      \
+  (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+#define DEC 10
+#define HEX 16
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define RISING 3
+#define LED_BUILTIN 13
+#define digitalPinToInterrupt(pin) (pin)
+
+uint32_t micros(void);
+uint32_t millis(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void yield(void) {}
+inline void noInterrupts(void) {}
+inline void interrupts(void) {}
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void attachInterrupt(uint8_t, void (*)(void), int) {}
+inline void detachInterrupt(uint8_t) {}
+
+/** Virtual clock in microseconds, micros() without the wrap around */
+uint64_t hostMicros(void);
+/** Freeze the virtual clock: micros() returns `us` until it is moved */
+void hostFreezeClock(uint64_t us);
+/** Move the virtual clock forward, frozen or not */
+void hostAdvanceClock(uint64_t us);
+/** Let the virtual clock run with the real clock again */
+void hostRunClock(void);
+
+/** Arduino String, on top of std::string */
+class String : public std::string {
+public:
+  String(const char *str = "") : std::string(str) {}
+  String(const std::string &str) : std::string(str) {}
+};
+
+/** Arduino Print, formatting numbers like the AVR core */
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--)
+      n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char *str) {
+    return write((const uint8_t *)str, strlen(str));
+  }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(const __FlashStringHelper *str) {
+    return print(reinterpret_cast<const char *>(str));
+  }
+  size_t print(const String &str) { return print(str.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) {
+    return print((unsigned long)n, base);
+  }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) {
+    return print((unsigned long)n, base);
+  }
+  size_t print(long n, int base = DEC) {
+    if (n < 0 && base == DEC)
+      return print('-') + print((unsigned long)-n, base);
+    return print((unsigned long)n, base);
+  }
+  size_t print(unsigned long n, int base = DEC) {
+    char buffer[24];
+    snprintf(buffer, sizeof buffer, base == HEX ? "%lX" : "%lu", n);
+    return print(buffer);
+  }
+  size_t print(double n, int digits = 2) {
+    char buffer[48];
+    snprintf(buffer, sizeof buffer, "%.*f", digits, n);
+    return print(buffer);
+  }
+
+  size_t println(void) { return print("\r\n"); }
+  template <class T> size_t println(const T &value) {
+    return print(value) + println();
+  }
+  template <class T> size_t println(const T &value, int format) {
+    return print(value, format) + println();
+  }
+};
+
+/** Serial port writing to the standard output */
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  void flush(void) { fflush(stdout); }
+  int available(void) { return 0; }
+  int read(void) { return -1; }
+  operator bool() { return true; }
+  size_t write(uint8_t c) { return c == '\r' ? 1 : putchar(c) != EOF; }
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,347 @@
+/*
+  Register-level models of the RTC chips, see RTCModels.h.
+*/
+
+#include "RTCModels.h"
+
+static RTCModel *models = nullptr;
+
+static uint8_t fromBcd(uint8_t v) { return v - 6 * (v >> 4); }
+static uint8_t toBcd(uint8_t v) { return v + 6 * (v / 10); }
+
+/** Attach a model to a bus. The derived class puts it in its power-up state */
+RTCModel::RTCModel(TwoWire *wire, uint8_t address, uint8_t size,
+                   uint8_t secondsRegister)
+    : size(size), secondsRegister(secondsRegister), pointer(0), driftPpb(0),
+      lastMicros(hostMicros()), phase(0), wire(wire), address(address),
+      next(models) {
+  memset(regs, 0, sizeof regs);
+  models = this;
+}
+
+RTCModel::~RTCModel() {
+  RTCModel **link = &models;
+  while (*link != this)
+    link = &(*link)->next;
+  *link = next;
+}
+
+/** Find the model attached to a bus and address, or nullptr */
+RTCModel *RTCModel::find(TwoWire *wire, uint8_t address) {
+  for (RTCModel *model = models; model; model = model->next)
+    if (model->wire == wire && model->address == address)
+      return model;
+  return nullptr;
+}
+
+/** START addressed to the chip: catch up with the elapsed time */
+void RTCModel::start(void) {
+  uint64_t now = hostMicros();
+  uint64_t elapsed = now - lastMicros;
+  lastMicros = now;
+  if (!running())
+    return;
+  elapse(elapsed);
+  int64_t rate = 1000000000 + driftPpb - trimPpb();
+  // In steps of at most 1000 s, for the product to fit
+  while (elapsed) {
+    int64_t step = elapsed < 1000000000 ? elapsed : 1000000000;
+    elapsed -= step;
+    phase += step * rate;
+    while (phase >= 1000000000000000LL) {
+      phase -= 1000000000000000LL;
+      tick();
+    }
+  }
+}
+
+/** Write the register at the pointer, then move the pointer to the next */
+void RTCModel::writeByte(uint8_t value) {
+  store(pointer, value);
+  // Writing the seconds resets the divider chain
+  if (pointer == secondsRegister)
+    phase = 0;
+  pointer = (pointer + 1) % size;
+}
+
+/** Read the register at the pointer, then move the pointer to the next */
+uint8_t RTCModel::readByte(void) {
+  uint8_t value = load(pointer);
+  pointer = (pointer + 1) % size;
+  return value;
+}
+
+/**
+  Set the time registers to 2000-01-01 00:00:00
+  @param weekdayRegister Register of the day of the week
+  @param firstWeekday Value of the first day of the week
+*/
+void RTCModel::clearTime(uint8_t weekdayRegister, uint8_t firstWeekday) {
+  uint8_t *t = regs + secondsRegister;
+  memset(t, 0, 7);
+  regs[weekdayRegister] = firstWeekday;
+  t[weekdayRegister == secondsRegister + 3 ? 4 : 3] = 1;
+  t[5] = 1;
+}
+
+/**
+  Advance the time registers by one second. They start with the seconds,
+  minutes and hours, then the day of the month and the day of the week in
+  some order, then the month and the year.
+  @param weekdayRegister Register of the day of the week
+  @param firstWeekday Value of the first day of the week
+  @param centuryBit Bit of the month register toggled when the year wraps
+*/
+void RTCModel::advanceCalendar(uint8_t weekdayRegister, uint8_t firstWeekday,
+                               uint8_t centuryBit) {
+  static const uint8_t monthDays[12] = {31, 28, 31, 30, 31, 30,
+                                        31, 31, 30, 31, 30, 31};
+  uint8_t *t = regs + secondsRegister;
+  uint8_t &weekday = regs[weekdayRegister];
+  uint8_t &day = t[weekdayRegister == secondsRegister + 3 ? 4 : 3];
+
+  uint8_t second = fromBcd(t[0] & 0x7F) + 1;
+  t[0] = (t[0] & 0x80) | toBcd(second % 60);
+  if (second < 60)
+    return;
+  uint8_t minute = fromBcd(t[1] & 0x7F) + 1;
+  t[1] = toBcd(minute % 60);
+  if (minute < 60)
+    return;
+  uint8_t hour = fromBcd(t[2] & 0x3F) + 1;
+  t[2] = toBcd(hour % 24);
+  if (hour < 24)
+    return;
+
+  weekday = ((weekday & 0x07) - firstWeekday + 1) % 7 + firstWeekday;
+  uint8_t year = fromBcd(t[6]);
+  uint8_t month = fromBcd(t[5] & 0x1F);
+  uint8_t days = month >= 1 && month <= 12 ? monthDays[month - 1] : 31;
+  if (month == 2 && year % 4 == 0)
+    days++;
+  uint8_t date = fromBcd(day & 0x3F) + 1;
+  if (date <= days) {
+    day = toBcd(date);
+    return;
+  }
+  day = 1;
+  if (month < 12) {
+    t[5] = (t[5] & centuryBit) | toBcd(month + 1);
+    return;
+  }
+  t[5] = ((t[5] & centuryBit) ^ centuryBit) | 1;
+  t[6] = toBcd((year + 1) % 100);
+}
+
+/*
+  DS1307: time at 0x00, with the Clock Halt bit in the seconds, control at
+  0x07 and RAM from 0x08 to 0x3F.
+*/
+
+DS1307Model::DS1307Model(TwoWire *wire) : RTCModel(wire, 0x68, 0x40, 0x00) {
+  powerUp();
+}
+
+void DS1307Model::powerUp(void) {
+  memset(regs, 0, size);
+  clearTime(0x03, 1);
+  regs[0x00] = 0x80; // CH
+  regs[0x07] = 0x03; // RS1, RS0
+}
+
+void DS1307Model::tick(void) { advanceCalendar(0x03, 1, 0); }
+
+/*
+  DS3231: time at 0x00, alarm 1 at 0x07, alarm 2 at 0x0B, control at 0x0E,
+  status at 0x0F, aging offset at 0x10 and temperature at 0x11.
+*/
+
+DS3231Model::DS3231Model(TwoWire *wire) : RTCModel(wire, 0x68, 0x13, 0x00) {
+  setTemperature(25);
+  powerUp();
+}
+
+void DS3231Model::powerUp(void) {
+  memset(regs, 0, size);
+  clearTime(0x03, 1);
+  regs[0x0E] = 0x1C; // INTCN, RS2, RS1
+  regs[0x0F] = 0x88; // OSF, EN32kHz
+  regs[0x11] = temperature[0];
+  regs[0x12] = temperature[1];
+  conversionMicros = 0;
+}
+
+/** Set the temperature that the next conversion measures */
+void DS3231Model::setTemperature(float celsius) {
+  int16_t quarters = (int16_t)(celsius * 4);
+  temperature[0] = (uint8_t)(quarters >> 2);
+  temperature[1] = (uint8_t)(quarters << 6);
+}
+
+void DS3231Model::tick(void) {
+  advanceCalendar(0x03, 1, 0x80);
+  if (alarmMatches(0x07, true))
+    regs[0x0F] |= 0x01; // A1F
+  if (regs[0x00] == 0 && alarmMatches(0x0B, false))
+    regs[0x0F] |= 0x02; // A2F
+}
+
+/**
+  Check an alarm against the time. Each alarm register holds a mask bit: the
+  fields whose bit is set are ignored.
+  @param first First alarm register
+  @param withSeconds Whether the alarm starts with the seconds
+  @return True if the alarm matches
+*/
+bool DS3231Model::alarmMatches(uint8_t first, bool withSeconds) {
+  const uint8_t *alarm = regs + first - !withSeconds;
+  for (uint8_t i = !withSeconds; i < 3; i++)
+    if (!(alarm[i] & 0x80) && (alarm[i] & 0x7F) != regs[i])
+      return false;
+  uint8_t dayDate = alarm[3];
+  if (dayDate & 0x80)
+    return true;
+  if (dayDate & 0x40) // DY
+    return (dayDate & 0x0F) == regs[0x03];
+  return (dayDate & 0x3F) == regs[0x04];
+}
+
+void DS3231Model::elapse(uint64_t us) {
+  if (!conversionMicros)
+    return;
+  if (us < conversionMicros) {
+    conversionMicros -= us;
+    return;
+  }
+  conversionMicros = 0;
+  regs[0x0E] &= ~0x20; // CONV
+  regs[0x0F] &= ~0x04; // BSY
+  regs[0x11] = temperature[0];
+  regs[0x12] = temperature[1];
+}
+
+void DS3231Model::store(uint8_t reg, uint8_t value) {
+  switch (reg) {
+  case 0x0E:
+    if ((value & 0x20) && !(regs[0x0F] & 0x04)) {
+      // A conversion takes 125 ms
+      conversionMicros = 125000;
+      regs[0x0F] |= 0x04;
+    }
+    regs[reg] = value | (regs[reg] & 0x20);
+    break;
+  case 0x0F:
+    // OSF, A2F and A1F can only be cleared, BSY is read-only
+    regs[reg] = (regs[reg] & value & 0x83) | (value & 0x08) |
+                (regs[reg] & 0x04);
+    break;
+  case 0x11:
+  case 0x12:
+    break;
+  default:
+    regs[reg] = value;
+  }
+}
+
+/*
+  PCF8523: control at 0x00 to 0x02, time at 0x03 with the Oscillator Stop
+  bit in the seconds, offset at 0x0E, timer control at 0x0F and timer B at
+  0x12 and 0x13.
+*/
+
+PCF8523Model::PCF8523Model(TwoWire *wire)
+    : RTCModel(wire, 0x68, 0x14, 0x03) {
+  powerUp();
+}
+
+void PCF8523Model::powerUp(void) {
+  memset(regs, 0, size);
+  clearTime(0x07, 0);
+  regs[0x02] = 0xE0; // battery switch-over disabled
+  regs[0x03] = 0x80; // OS
+  memset(regs + 0x0A, 0x80, 4);
+  countdown = 0;
+  timerPhase = 0;
+}
+
+void PCF8523Model::tick(void) {
+  advanceCalendar(0x07, 0, 0);
+  if (regs[0x00] & 0x04) // SIE
+    regs[0x01] |= 0x10;  // SF
+}
+
+void PCF8523Model::elapse(uint64_t us) {
+  // Period of the timer B source clock, in ns
+  static const uint64_t periods[8] = {
+      244141,        15625000,      1000000000,    60000000000,
+      3600000000000, 3600000000000, 3600000000000, 3600000000000};
+  uint8_t reload = regs[0x13];
+  if (!(regs[0x0F] & 0x01) || !reload || !countdown) // TBC
+    return;
+  uint64_t period = periods[regs[0x12] & 0x07];
+  timerPhase += us * 1000;
+  uint64_t periodsElapsed = timerPhase / period;
+  timerPhase %= period;
+  if (periodsElapsed >= countdown) {
+    regs[0x01] |= 0x20; // CTBF
+    periodsElapsed = (periodsElapsed - countdown) % reload;
+    countdown = reload;
+  }
+  countdown -= periodsElapsed;
+}
+
+int32_t PCF8523Model::trimPpb(void) {
+  // A 7-bit signed offset, in steps of 4.34 ppm or of 4.069 ppm in mode 1
+  int8_t offset = (int8_t)(regs[0x0E] << 1) >> 1;
+  return offset * (regs[0x0E] & 0x80 ? 4069 : 4340);
+}
+
+void PCF8523Model::store(uint8_t reg, uint8_t value) {
+  switch (reg) {
+  case 0x01:
+    // The flags can only be cleared
+    regs[reg] = (regs[reg] & value & 0xF8) | (value & 0x07);
+    break;
+  case 0x0F:
+    // Enabling timer B loads its value
+    if ((value & 0x01) && !(regs[reg] & 0x01)) {
+      countdown = regs[0x13];
+      timerPhase = 0;
+    }
+    regs[reg] = value;
+    break;
+  case 0x13:
+    countdown = value;
+    timerPhase = 0;
+    regs[reg] = value;
+    break;
+  default:
+    regs[reg] = value;
+  }
+}
+
+uint8_t PCF8523Model::load(uint8_t reg) {
+  return reg == 0x13 ? countdown : regs[reg];
+}
+
+/*
+  PCF8563: control at 0x00 and 0x01, time at 0x02 with the Voltage Low bit
+  in the seconds, CLKOUT control at 0x0D.
+*/
+
+PCF8563Model::PCF8563Model(TwoWire *wire)
+    : RTCModel(wire, 0x51, 0x10, 0x02) {
+  powerUp();
+}
+
+void PCF8563Model::powerUp(void) {
+  memset(regs, 0, size);
+  clearTime(0x06, 0);
+  regs[0x00] = 0x08; // TESTC
+  regs[0x02] = 0x80; // VL
+  memset(regs + 0x09, 0x80, 4);
+  regs[0x0D] = 0x80; // FE
+  regs[0x0E] = 0x03;
+}
+
+void PCF8563Model::tick(void) { advanceCalendar(0x06, 0, 0x80); }
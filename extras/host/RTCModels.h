@@ -0,0 +1,139 @@
+/*
+  Register-level models of the RTC chips, for the host build.
+
+  A model attaches to an I2C bus and address, where the Adafruit_I2CDevice
+  stand-in finds it. It holds the register file of the chip, with its
+  register pointer and its auto-increment, and keeps time from the virtual
+  clock of the host: the elapsed time is caught up at each START, the way
+  the chips latch their time registers. The flags the drivers rely on are
+  modelled: power loss, clock halt and stop bits, the flags that can only be
+  cleared, the DS3231 alarms and temperature conversions, and the PCF8523
+  second and countdown timers. Hours are kept in 24-hour mode only, and the
+  interrupt and square wave pins are not modelled.
+*/
+
+#ifndef HOST_RTC_MODELS_H
+#define HOST_RTC_MODELS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/** Model of an RTC chip on an I2C bus */
+class RTCModel {
+public:
+  RTCModel(TwoWire *wire, uint8_t address, uint8_t size,
+           uint8_t secondsRegister);
+  virtual ~RTCModel();
+  static RTCModel *find(TwoWire *wire, uint8_t address);
+
+  /** Put the registers in their state after a power loss */
+  virtual void powerUp(void) = 0;
+  /**
+    Set the frequency error of the crystal
+    @param ppm Frequency error in parts per million, positive if fast
+  */
+  void setDriftPpm(float ppm) { driftPpb = (int32_t)(ppm * 1000); }
+  /** Read a register without any bus traffic, e.g. to check a test */
+  uint8_t peek(uint8_t reg) { return load(reg); }
+  /** Write a register without any bus traffic, e.g. to set up a test */
+  void poke(uint8_t reg, uint8_t value) { regs[reg] = value; }
+
+  // Interface with the Adafruit_I2CDevice stand-in
+  void start(void);
+  void setPointer(uint8_t reg) { pointer = reg < size ? reg : 0; }
+  void writeByte(uint8_t value);
+  uint8_t readByte(void);
+
+protected:
+  /** Whether the oscillator runs */
+  virtual bool running(void) { return true; }
+  /** Advance the registers by one second */
+  virtual void tick(void) = 0;
+  /** Let sub-second timers run for the given time */
+  virtual void elapse(uint64_t us) {}
+  /** Frequency correction of the chip in parts per billion, positive slows */
+  virtual int32_t trimPpb(void) { return 0; }
+  /** Register write, with the side effects of the chip */
+  virtual void store(uint8_t reg, uint8_t value) { regs[reg] = value; }
+  /** Register read, with the side effects of the chip */
+  virtual uint8_t load(uint8_t reg) { return regs[reg]; }
+
+  void clearTime(uint8_t weekdayRegister, uint8_t firstWeekday);
+  void advanceCalendar(uint8_t weekdayRegister, uint8_t firstWeekday,
+                       uint8_t centuryBit);
+
+  uint8_t regs[64]; ///< Register file
+  uint8_t size;     ///< Number of registers, where the pointer wraps around
+
+private:
+  uint8_t secondsRegister;
+  uint8_t pointer;
+  int32_t driftPpb;
+  uint64_t lastMicros;
+  int64_t phase; // progress of the current second, in us times 1e9
+  TwoWire *wire;
+  uint8_t address;
+  RTCModel *next;
+};
+
+/** Model of the DS1307: halted after a power loss, with 56 bytes of RAM */
+class DS1307Model : public RTCModel {
+public:
+  DS1307Model(TwoWire *wire = &Wire);
+  void powerUp(void);
+
+protected:
+  bool running(void) { return !(regs[0] & 0x80); }
+  void tick(void);
+};
+
+/** Model of the DS3231, with its alarms and temperature conversions */
+class DS3231Model : public RTCModel {
+public:
+  DS3231Model(TwoWire *wire = &Wire);
+  void powerUp(void);
+  void setTemperature(float celsius);
+
+protected:
+  void tick(void);
+  void elapse(uint64_t us);
+  int32_t trimPpb(void) { return (int8_t)regs[0x10] * 100; }
+  void store(uint8_t reg, uint8_t value);
+
+private:
+  bool alarmMatches(uint8_t first, bool withSeconds);
+  uint32_t conversionMicros; // time left before the conversion completes
+  uint8_t temperature[2];    // result of the next conversion
+};
+
+/** Model of the PCF8523, with its second and countdown B timers */
+class PCF8523Model : public RTCModel {
+public:
+  PCF8523Model(TwoWire *wire = &Wire);
+  void powerUp(void);
+
+protected:
+  bool running(void) { return !(regs[0x00] & 0x20); }
+  void tick(void);
+  void elapse(uint64_t us);
+  int32_t trimPpb(void);
+  void store(uint8_t reg, uint8_t value);
+  uint8_t load(uint8_t reg);
+
+private:
+  uint8_t countdown;   // current value of timer B
+  uint64_t timerPhase; // progress of the current timer B period, in ns
+};
+
+/** Model of the PCF8563: flags a low voltage after a power loss */
+class PCF8563Model : public RTCModel {
+public:
+  PCF8563Model(TwoWire *wire = &Wire);
+  void powerUp(void);
+
+protected:
+  bool running(void) { return !(regs[0x00] & 0x20); }
+  void tick(void);
+};
+
+#endif // HOST_RTC_MODELS_H
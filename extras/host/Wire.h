@@ -0,0 +1,23 @@
+/*
+  I2C bus of the host build. It only identifies a bus: the transfers are
+  done by the Adafruit_I2CDevice stand-in, on the chip models attached to
+  the bus.
+*/
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+/** An I2C bus */
+class TwoWire {
+public:
+  TwoWire() : frequency(100000) {}
+  void begin(void) {}
+  void setClock(uint32_t clock) { frequency = clock; }
+  uint32_t frequency; ///< Bus clock in Hz, for the bus time of the transfers
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,182 @@
+/*
+  I2C cost of the public calls of the RTC drivers, measured on the chip
+  models. Prints a Markdown table of the transactions, data bytes and bus
+  time at 100 kHz of each call. Comparing the table before and after a
+  change to a driver shows whether it added or removed bus round trips.
+*/
+
+#include <RTClib.h>
+
+#include "RTCModels.h"
+
+#include <functional>
+
+static const DateTime when(2024, 2, 29, 12, 34, 56);
+
+/** Print the I2C traffic of a call */
+static void measure(const char *name, const std::function<void()> &call) {
+  i2cCounters.reset();
+  call();
+  printf("| `%s` | %u | %u | %u |\n", name,
+         (unsigned)i2cCounters.transactions, (unsigned)i2cCounters.bytes,
+         (unsigned)i2cCounters.busMicros);
+}
+
+/** Poll a non-blocking transfer to completion */
+template <class Poll> static void complete(Poll poll) {
+  while (!poll())
+    ;
+}
+
+static void ds1307(void) {
+  TwoWire bus;
+  DS1307Model model(&bus);
+  RTC_DS1307 rtc;
+  uint8_t ram[8] = {0};
+  measure("RTC_DS1307::begin()", [&] { rtc.begin(&bus); });
+  measure("RTC_DS1307::adjust()", [&] { rtc.adjust(when); });
+  measure("RTC_DS1307::now()", [&] { rtc.now(); });
+  measure("RTC_DS1307::requestNow() + pollNow()", [&] {
+    DateTime dt;
+    rtc.requestNow();
+    complete([&] { return rtc.pollNow(dt); });
+  });
+  measure("RTC_DS1307::requestAdjust() + pollAdjust()", [&] {
+    rtc.requestAdjust(when);
+    complete([&] { return rtc.pollAdjust(); });
+  });
+  measure("RTC_DS1307::isrunning()", [&] { rtc.isrunning(); });
+  measure("RTC_DS1307::lostPower()", [&] { rtc.lostPower(); });
+  measure("RTC_DS1307::readSqwPinMode()", [&] { rtc.readSqwPinMode(); });
+  measure("RTC_DS1307::writeSqwPinMode()",
+          [&] { rtc.writeSqwPinMode(DS1307_SquareWave1HZ); });
+  measure("RTC_DS1307::readnvram(8 bytes)",
+          [&] { rtc.readnvram(ram, sizeof ram, 0); });
+  measure("RTC_DS1307::writenvram(8 bytes)",
+          [&] { rtc.writenvram(0, ram, sizeof ram); });
+}
+
+static void ds3231(void) {
+  TwoWire bus;
+  DS3231Model model(&bus);
+  RTC_DS3231 rtc;
+  measure("RTC_DS3231::begin()", [&] { rtc.begin(&bus); });
+  measure("RTC_DS3231::adjust()", [&] { rtc.adjust(when); });
+  measure("RTC_DS3231::now()", [&] { rtc.now(); });
+  measure("RTC_DS3231::requestNow() + pollNow()", [&] {
+    DateTime dt;
+    rtc.requestNow();
+    complete([&] { return rtc.pollNow(dt); });
+  });
+  measure("RTC_DS3231::requestAdjust() + pollAdjust()", [&] {
+    rtc.requestAdjust(when);
+    complete([&] { return rtc.pollAdjust(); });
+  });
+  measure("RTC_DS3231::lostPower()", [&] { rtc.lostPower(); });
+  measure("RTC_DS3231::readSqwPinMode()", [&] { rtc.readSqwPinMode(); });
+  measure("RTC_DS3231::writeSqwPinMode()",
+          [&] { rtc.writeSqwPinMode(DS3231_OFF); });
+  measure("RTC_DS3231::setAlarm1()",
+          [&] { rtc.setAlarm1(when, DS3231_A1_Hour); });
+  measure("RTC_DS3231::setAlarm2()",
+          [&] { rtc.setAlarm2(when, DS3231_A2_Minute); });
+  measure("RTC_DS3231::getAlarm1()", [&] { rtc.getAlarm1(); });
+  measure("RTC_DS3231::getAlarm2()", [&] { rtc.getAlarm2(); });
+  measure("RTC_DS3231::getAlarm1Mode()", [&] { rtc.getAlarm1Mode(); });
+  measure("RTC_DS3231::getAlarm2Mode()", [&] { rtc.getAlarm2Mode(); });
+  measure("RTC_DS3231::alarmFired()", [&] { rtc.alarmFired(1); });
+  measure("RTC_DS3231::clearAlarm()", [&] { rtc.clearAlarm(1); });
+  measure("RTC_DS3231::disableAlarm()", [&] { rtc.disableAlarm(2); });
+  measure("RTC_DS3231::enable32K()", [&] { rtc.enable32K(); });
+  measure("RTC_DS3231::disable32K()", [&] { rtc.disable32K(); });
+  measure("RTC_DS3231::isEnabled32K()", [&] { rtc.isEnabled32K(); });
+  measure("RTC_DS3231::getTemperature()", [&] { rtc.getTemperature(); });
+  measure("RTC_DS3231::readAgingOffset()", [&] { rtc.readAgingOffset(); });
+  measure("RTC_DS3231::writeAgingOffset()", [&] { rtc.writeAgingOffset(0); });
+  measure("RTC_DS3231::forceConversion(false)",
+          [&] { rtc.forceConversion(false); });
+  delay(200);
+  measure("RTC_DS3231::forceConversion(true)",
+          [&] { rtc.forceConversion(true); });
+  measure("RTC_DS3231::getSnapshot()", [&] { rtc.getSnapshot(); });
+  measure("RTC_DS3231::enableRegisterCache()",
+          [&] { rtc.enableRegisterCache(); });
+  measure("RTC_DS3231::writeSqwPinMode(), cached",
+          [&] { rtc.writeSqwPinMode(DS3231_SquareWave1Hz); });
+  measure("RTC_DS3231::clearAlarm(), cached", [&] { rtc.clearAlarm(1); });
+}
+
+static void pcf8523(void) {
+  TwoWire bus;
+  PCF8523Model model(&bus);
+  RTC_PCF8523 rtc;
+  measure("RTC_PCF8523::begin()", [&] { rtc.begin(&bus); });
+  measure("RTC_PCF8523::adjust()", [&] { rtc.adjust(when); });
+  measure("RTC_PCF8523::now()", [&] { rtc.now(); });
+  measure("RTC_PCF8523::requestNow() + pollNow()", [&] {
+    DateTime dt;
+    rtc.requestNow();
+    complete([&] { return rtc.pollNow(dt); });
+  });
+  measure("RTC_PCF8523::requestAdjust() + pollAdjust()", [&] {
+    rtc.requestAdjust(when);
+    complete([&] { return rtc.pollAdjust(); });
+  });
+  measure("RTC_PCF8523::lostPower()", [&] { rtc.lostPower(); });
+  measure("RTC_PCF8523::initialized()", [&] { rtc.initialized(); });
+  measure("RTC_PCF8523::isrunning()", [&] { rtc.isrunning(); });
+  measure("RTC_PCF8523::stop()", [&] { rtc.stop(); });
+  measure("RTC_PCF8523::start()", [&] { rtc.start(); });
+  measure("RTC_PCF8523::readSqwPinMode()", [&] { rtc.readSqwPinMode(); });
+  measure("RTC_PCF8523::writeSqwPinMode()",
+          [&] { rtc.writeSqwPinMode(PCF8523_SquareWave1HZ); });
+  measure("RTC_PCF8523::enableSecondTimer()", [&] { rtc.enableSecondTimer(); });
+  measure("RTC_PCF8523::disableSecondTimer()",
+          [&] { rtc.disableSecondTimer(); });
+  measure("RTC_PCF8523::enableCountdownTimer()", [&] {
+    rtc.enableCountdownTimer(PCF8523_FrequencySecond, 10);
+  });
+  measure("RTC_PCF8523::disableCountdownTimer()",
+          [&] { rtc.disableCountdownTimer(); });
+  measure("RTC_PCF8523::deconfigureAllTimers()",
+          [&] { rtc.deconfigureAllTimers(); });
+  measure("RTC_PCF8523::calibrate()",
+          [&] { rtc.calibrate(PCF8523_TwoHours, 0); });
+}
+
+static void pcf8563(void) {
+  TwoWire bus;
+  PCF8563Model model(&bus);
+  RTC_PCF8563 rtc;
+  measure("RTC_PCF8563::begin()", [&] { rtc.begin(&bus); });
+  measure("RTC_PCF8563::adjust()", [&] { rtc.adjust(when); });
+  measure("RTC_PCF8563::now()", [&] { rtc.now(); });
+  measure("RTC_PCF8563::requestNow() + pollNow()", [&] {
+    DateTime dt;
+    rtc.requestNow();
+    complete([&] { return rtc.pollNow(dt); });
+  });
+  measure("RTC_PCF8563::requestAdjust() + pollAdjust()", [&] {
+    rtc.requestAdjust(when);
+    complete([&] { return rtc.pollAdjust(); });
+  });
+  measure("RTC_PCF8563::lostPower()", [&] { rtc.lostPower(); });
+  measure("RTC_PCF8563::isrunning()", [&] { rtc.isrunning(); });
+  measure("RTC_PCF8563::stop()", [&] { rtc.stop(); });
+  measure("RTC_PCF8563::start()", [&] { rtc.start(); });
+  measure("RTC_PCF8563::readSqwPinMode()", [&] { rtc.readSqwPinMode(); });
+  measure("RTC_PCF8563::writeSqwPinMode()",
+          [&] { rtc.writeSqwPinMode(PCF8563_SquareWave1Hz); });
+}
+
+int main() {
+  // Freeze the clock so that only the bus time moves it
+  hostFreezeClock(0);
+  printf("| Call | Transactions | Bytes | Bus time (us) |\n");
+  printf("| --- | ---: | ---: | ---: |\n");
+  ds1307();
+  ds3231();
+  pcf8523();
+  pcf8563();
+  return 0;
+}
@@ -0,0 +1,54 @@
+/*
+  Virtual clock and globals of the host Arduino core.
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <time.h>
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static int64_t clockOffset = 0; // virtual minus real time, in us
+static bool clockFrozen = false;
+static uint64_t frozenMicros = 0;
+
+/** Microseconds of the monotonic real clock */
+static int64_t realMicros(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t hostMicros(void) {
+  if (clockFrozen)
+    return frozenMicros;
+  return realMicros() + clockOffset;
+}
+
+uint32_t micros(void) { return (uint32_t)hostMicros(); }
+
+uint32_t millis(void) { return (uint32_t)(hostMicros() / 1000); }
+
+void delay(unsigned long ms) { hostAdvanceClock((uint64_t)ms * 1000); }
+
+void delayMicroseconds(unsigned int us) { hostAdvanceClock(us); }
+
+void hostFreezeClock(uint64_t us) {
+  clockFrozen = true;
+  frozenMicros = us;
+}
+
+void hostAdvanceClock(uint64_t us) {
+  if (clockFrozen)
+    frozenMicros += us;
+  else
+    clockOffset += us;
+}
+
+void hostRunClock(void) {
+  if (clockFrozen)
+    clockOffset = (int64_t)frozenMicros - realMicros();
+  clockFrozen = false;
+}
@@ -0,0 +1,19 @@
+/*
+  Run an example sketch on the host: setup() once, then loop() SKETCH_LOOPS
+  times. SKETCH is the path of the .ino file.
+*/
+
+#include <Arduino.h>
+
+#include SKETCH
+
+#ifndef SKETCH_LOOPS
+#define SKETCH_LOOPS 1
+#endif
+
+int main() {
+  setup();
+  for (long i = 0; i < SKETCH_LOOPS; i++)
+    loop();
+  return 0;
+}
@@ -0,0 +1,359 @@
+/*
+  Regression tests of RTClib, run on the host against the virtual clock and
+  the chip models. Each test returns normally, and CHECK() counts the
+  failures, which make the exit status non-zero.
+*/
+
+#include <RTClib.h>
+
+#include "RTCModels.h"
+
+static int failures = 0;
+
+/** Report a failed condition, and carry on */
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #condition);           \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+/*
+  RTC_Micros: a drift correction whose fractions of a microsecond add up
+  to more than the elapsed time must not move the clock ahead of micros().
+*/
+static void testMicrosFraction(void) {
+  hostFreezeClock(0);
+  RTC_Micros clock;
+  clock.begin(DateTime(2000, 1, 1));
+  clock.adjustDriftPpb(-999);
+  hostAdvanceClock(2000000);
+  DateTime first = clock.now();
+  DateTime second = clock.now();
+  CHECK(first == second);
+  CHECK(second == DateTime(2000, 1, 1, 0, 0, 1));
+  hostAdvanceClock(1000);
+  CHECK(clock.now() == DateTime(2000, 1, 1, 0, 0, 2));
+}
+
+/*
+  RTC_Micros: a drift correction beyond 32,768 ppm must not change sign.
+*/
+static void testMicrosLargeDrift(void) {
+  hostFreezeClock(0);
+  RTC_Micros clock;
+  clock.begin(DateTime(2000, 1, 1));
+  clock.adjustDriftPpb(40000000); // 40,000 ppm faster
+  hostAdvanceClock(1000000000);
+  CHECK(clock.now() == DateTime(2000, 1, 1, 0, 17, 21)); // 1040 s
+  clock.adjust(DateTime(2000, 1, 1));
+  clock.adjustDriftPpb(-40000000);
+  hostAdvanceClock(1000000000);
+  CHECK(clock.now() == DateTime(2000, 1, 1, 0, 16, 1)); // 961 s
+}
+
+/*
+  RTC_Discipline: drifts that accumulate more than the 128 ms step
+  threshold over an update interval must still lock.
+*/
+static void testDisciplineLock(float ppm) {
+  hostFreezeClock(0);
+  TwoWire bus;
+  DS3231Model model(&bus);
+  // The RTC runs fast by as much as micros() runs slow
+  model.setDriftPpm(ppm);
+  RTC_DS3231 rtc;
+  rtc.begin(&bus);
+  rtc.adjust(DateTime(2024, 1, 1));
+  RTC_Micros clock;
+  RTC_Discipline<RTC_DS3231> discipline(rtc, clock);
+  for (int i = 0; i < 16; i++) {
+    discipline.update();
+    hostAdvanceClock(600000000);
+  }
+  // micros() is slow against the RTC by 1 - 1 / (1 + drift)
+  float expected = 1e6f * (1 - 1 / (1 + ppm * 1e-6f));
+  CHECK(discipline.locked());
+  CHECK(discipline.frequency() > expected - 1 &&
+        discipline.frequency() < expected + 1);
+  CHECK(discipline.offset() > -5000 && discipline.offset() < 5000);
+}
+
+/*
+  Split-phase transfers: setting the time must be a single transaction, so
+  that the seconds cannot roll over between two parts of it.
+*/
+static void testSplitPhaseAdjust(void) {
+  hostFreezeClock(0);
+  TwoWire bus;
+  PCF8563Model model(&bus);
+  RTC_PCF8563 rtc;
+  rtc.begin(&bus);
+  DateTime set(2024, 12, 31, 23, 59, 59);
+  rtc.requestAdjust(set);
+  i2cCounters.reset();
+  CHECK(rtc.pollAdjust());
+  CHECK(i2cCounters.transactions == 1);
+  CHECK(rtc.now() == set);
+  hostAdvanceClock(1000000);
+  DateTime dt;
+  rtc.requestNow();
+  while (!rtc.pollNow(dt))
+    hostAdvanceClock(100000);
+  CHECK(dt == DateTime(2025, 1, 1));
+}
+
+/*
+  RTC_Redundant: with two members, the one that lost power must be set from
+  the other, and healthy queries must not read the power loss flags.
+*/
+static void testRedundantLostPower(void) {
+  hostFreezeClock(0);
+  TwoWire bus1, bus2;
+  DS3231Model model1(&bus1);
+  PCF8563Model model2(&bus2);
+  RTC_DS3231 rtc1;
+  RTC_PCF8563 rtc2;
+  rtc1.begin(&bus1);
+  rtc2.begin(&bus2);
+  DateTime set(2024, 6, 1, 12, 0, 0);
+  rtc1.adjust(set);
+  rtc2.adjust(set);
+  model2.powerUp();
+
+  RTC_Redundant redundant;
+  redundant.add(rtc1);
+  redundant.add(rtc2);
+  CHECK(redundant.majority() == 1);
+  CHECK(redundant.now() == set);
+  CHECK(redundant.faults() == 0x02);
+  CHECK(!rtc2.lostPower());
+  CHECK(rtc2.now() == set);
+  CHECK(redundant.majority() == 2);
+
+  i2cCounters.reset();
+  CHECK(redundant.now() == set);
+  CHECK(redundant.confidence() == 2);
+  CHECK(redundant.faults() == 0);
+  CHECK(i2cCounters.transactions == 4); // two reads of the time
+}
+
+/*
+  parseIso8601(): the minutes of the UTC offset are optional, but not after
+  a colon.
+*/
+static void testIso8601Offset(void) {
+  Iso8601Result r = parseIso8601("2024-01-01T00:00:00+05:");
+  CHECK(r.status == ISO8601_SYNTAX);
+  r = parseIso8601("2024-01-01T00:00:00+05:3");
+  CHECK(r.status == ISO8601_SYNTAX);
+  r = parseIso8601("2024-01-01T00:00:00+05");
+  CHECK(r.status == ISO8601_OK && r.offset == 300);
+  r = parseIso8601("2024-01-01T00:00:00-0530");
+  CHECK(r.status == ISO8601_OK && r.offset == -330);
+  r = parseIso8601("2024-01-01T00:00:00+05:30");
+  CHECK(r.status == ISO8601_OK && r.offset == 330 && r.length == 25);
+}
+
+/*
+  Timestamps: the longest one, with out-of-range fields and offset, must fit
+  in TIMESTAMP_BUFFER_SIZE.
+*/
+static void testTimestampBuffer(void) {
+  struct {
+    char buffer[TIMESTAMP_BUFFER_SIZE];
+    char guard[8];
+  } out;
+  memset(out.guard, '#', sizeof out.guard);
+  PreciseDateTime worst(DateTime(2255, 255, 255, 255, 255, 255), 999999);
+  size_t len = worst.preciseTimestamp(out.buffer, 6, -32767);
+  CHECK(len == strlen(out.buffer) && len < TIMESTAMP_BUFFER_SIZE);
+  CHECK(memcmp(out.guard, "########", 8) == 0);
+  CHECK(strcmp(out.buffer + len - 6, "-23:59") == 0);
+
+  PreciseDateTime dt(DateTime(2024, 1, 2, 3, 4, 5), 123456);
+  dt.preciseTimestamp(out.buffer, 3, 330);
+  CHECK(strcmp(out.buffer, "2024-01-02T03:04:05.123+05:30") == 0);
+}
+
+/*
+  RTC_Cached: the phase measured by syncToEdge(), or narrowed by the resyncs,
+  must survive the resyncs that see the RTC tick earlier than extrapolated.
+*/
+static void testCachedErrorBound(void) {
+  hostFreezeClock(0);
+  TwoWire bus;
+  DS3231Model model(&bus);
+  model.setDriftPpm(50); // ticks early against micros()
+  RTC_DS3231 rtc;
+  rtc.begin(&bus);
+  rtc.adjust(DateTime(2024, 1, 1));
+  hostAdvanceClock(300000);
+
+  RTC_Cached<RTC_DS3231> cached(rtc, 1);
+  cached.now();
+  CHECK(cached.errorBound() == 1000000);
+  uint32_t bound = 1000000;
+  for (int i = 0; i < 20; i++) {
+    hostAdvanceClock(1130000);
+    cached.now();
+    bound = cached.errorBound() < bound ? cached.errorBound() : bound;
+  }
+  CHECK(bound < 1000000);
+
+  cached.syncToEdge();
+  CHECK(cached.errorBound() < 10000);
+  for (int i = 0; i < 400; i++) {
+    hostAdvanceClock(1130000);
+    DateTime cachedNow = cached.now();
+    CHECK(cached.errorBound() < 100000);
+    CHECK(cachedNow == rtc.now());
+  }
+}
+
+/*
+  DateTime(uint32_t): the closed form must give the same fields as the
+  year and month loops it replaced, for every day of 2000-2099.
+*/
+static void testDateTimeFromUnix(void) {
+  static const uint8_t monthDays[12] = {31, 28, 31, 30, 31, 30,
+                                        31, 31, 30, 31, 30, 31};
+  static const uint32_t times[] = {0, 1, 43199, 43200, 86399};
+  for (uint16_t day = 0; day < 36525; day++) {
+    // The former implementation
+    uint16_t days = day;
+    uint8_t y, m, leap;
+    for (y = 0;; ++y) {
+      leap = y % 4 == 0;
+      if (days < 365U + leap)
+        break;
+      days -= 365 + leap;
+    }
+    for (m = 1; m < 12; ++m) {
+      uint8_t daysPerMonth = monthDays[m - 1];
+      if (leap && m == 2)
+        ++daysPerMonth;
+      if (days < daysPerMonth)
+        break;
+      days -= daysPerMonth;
+    }
+    for (uint32_t time : times) {
+      DateTime dt(SECONDS_FROM_1970_TO_2000 + day * 86400UL + time);
+      CHECK(dt.year() == 2000 + y && dt.month() == m && dt.day() == days + 1);
+      CHECK(dt.hour() == time / 3600 && dt.minute() == time / 60 % 60 &&
+            dt.second() == time % 60);
+    }
+  }
+}
+
+/*
+  RTC_SqwClock: no fraction of the second before the first edge, then the
+  time since the last edge. It also serves as a reference clock.
+*/
+static void testSqwClockFraction(void) {
+  hostFreezeClock(12345678);
+  RTC_SqwClock clock;
+  clock.adjust(DateTime(2024, 1, 1));
+  hostAdvanceClock(250000);
+  PreciseDateTime dt = clock.nowPrecise();
+  CHECK(dt == DateTime(2024, 1, 1) && dt.microsecond() == 0);
+  hostAdvanceClock(1000000);
+  CHECK(clock.nowPrecise() == DateTime(2024, 1, 1, 0, 0, 1));
+
+  clock.tick();
+  clock.adjust(DateTime(2024, 1, 1, 0, 0, 2));
+  hostAdvanceClock(123456);
+  dt = clock.nowPrecise();
+  CHECK(dt.unixtime() == DateTime(2024, 1, 1, 0, 0, 2).unixtime());
+  CHECK(dt.microsecond() == 123456);
+  CHECK(clock.now() == DateTime(2024, 1, 1, 0, 0, 2));
+
+  RTC_Cached<RTC_SqwClock> cached(clock);
+  CHECK(cached.now() == DateTime(2024, 1, 1, 0, 0, 2));
+}
+
+/*
+  AlarmScheduler: a new earliest deadline that is not earlier than the one
+  programmed needs no read of the time, and is still polled if it passed.
+*/
+static void testSchedulerBusReads(void) {
+  hostFreezeClock(0);
+  TwoWire bus;
+  DS3231Model model(&bus);
+  RTC_DS3231 rtc;
+  rtc.begin(&bus);
+  DateTime start(2024, 6, 1, 12, 0, 0);
+  rtc.adjust(start);
+  AlarmScheduler::Entry entries[4];
+  AlarmScheduler scheduler(rtc, entries, 4);
+  scheduler.begin();
+
+  i2cCounters.reset();
+  rtc.setAlarm1(start + TimeSpan(5), DS3231_A1_Date);
+  uint32_t setAlarm = i2cCounters.transactions;
+
+  scheduler.add(1, start + TimeSpan(5));
+  scheduler.add(2, start + TimeSpan(2));
+  i2cCounters.reset();
+  scheduler.remove(2);
+  CHECK(i2cCounters.transactions == setAlarm);
+
+  uint8_t id;
+  hostAdvanceClock(1000000);
+  CHECK(!scheduler.poll(id));
+  scheduler.add(2, start + TimeSpan(3));
+  hostAdvanceClock(5000000);
+  i2cCounters.reset();
+  scheduler.remove(2); // alarm 2 fired, 1 is past
+  CHECK(i2cCounters.transactions == setAlarm);
+  CHECK(scheduler.poll(id) && id == 1);
+  CHECK(!scheduler.poll(id) && scheduler.count() == 0);
+}
+
+/*
+  RTC_Discipline: the first update() has no offset to report, and an offset
+  near 2^32 microseconds must be stepped, not taken modulo 2^32.
+*/
+static void testDisciplineLargeOffset(void) {
+  hostFreezeClock(0);
+  TwoWire bus;
+  DS3231Model model(&bus);
+  RTC_DS3231 rtc;
+  rtc.begin(&bus);
+  rtc.adjust(DateTime(2024, 1, 1));
+  RTC_Micros clock;
+  clock.begin(DateTime(2030, 1, 1));
+  RTC_Discipline<RTC_DS3231> discipline(rtc, clock);
+  CHECK(discipline.update());
+  CHECK(discipline.offset() == 0);
+
+  hostAdvanceClock(600000000);
+  clock.adjust(clock.nowPrecise() + PreciseTimeSpan(4294, 967296 + 50000));
+  CHECK(discipline.update());
+  CHECK(discipline.offset() == 0);
+  CHECK(clock.now() == rtc.now());
+}
+
+int main() {
+  testDateTimeFromUnix();
+  testMicrosFraction();
+  testMicrosLargeDrift();
+  testDisciplineLock(100);
+  testDisciplineLock(300);
+  testDisciplineLock(1000);
+  testDisciplineLock(-1000);
+  testDisciplineLargeOffset();
+  testSplitPhaseAdjust();
+  testRedundantLostPower();
+  testIso8601Offset();
+  testTimestampBuffer();
+  testCachedErrorBound();
+  testSqwClockFraction();
+  testSchedulerBusReads();
+  if (failures)
+    printf("%d failures\n", failures);
+  else
+    printf("All tests passed\n");
+  return failures != 0;
+}
@@ -0,0 +1,205 @@
+#include "RTClib.h"
+
+/**************************************************************************/
+/*!
+    @brief  Create an alarm scheduler.
+    @param rtc The DS3231 whose alarm is used
+    @param entries Array holding the queue
+    @param capacity Number of elements of `entries`
+    @param alarm_num Hardware alarm to use, 1 or 2
+*/
+/**************************************************************************/
+AlarmScheduler::AlarmScheduler(RTC_DS3231 &rtc, Entry *entries,
+                               uint8_t capacity, uint8_t alarm_num)
+    : rtc(rtc), heap(entries), capacity(capacity), size(0),
+      alarmNum(alarm_num), pending(false), due(0), programmed(0) {}
+
+/**************************************************************************/
+/*!
+    @brief  Take control of the hardware alarm. This configures the SQW/INT
+            pin as an interrupt output and programs the earliest alarm
+            already scheduled, if any.
+    @details Call this after RTC_DS3231::begin().
+    @return True
+*/
+/**************************************************************************/
+bool AlarmScheduler::begin() {
+  rtc.writeSqwPinMode(DS3231_OFF);
+  rtc.disableAlarm(alarmNum);
+  rtc.clearAlarm(alarmNum);
+  programmed = 0;
+  program();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Schedule an alarm, replacing any alarm with the same identifier.
+    @param id Identifier of the alarm, returned by poll() when it fires
+    @param when Date and time of the first deadline
+    @param period Repetition period in seconds, or 0 for a single shot.
+        Periods missed while the alarm was not polled are skipped.
+    @return False if the queue is full, true otherwise.
+*/
+/**************************************************************************/
+bool AlarmScheduler::add(uint8_t id, const DateTime &when, uint32_t period) {
+  uint8_t i = 0;
+  while (i < size && heap[i].id != id)
+    i++;
+  if (i == capacity)
+    return false;
+  if (i == size)
+    size++;
+  heap[i].time = when.unixtime();
+  heap[i].period = period;
+  heap[i].id = id;
+  siftUp(i);
+  siftDown(i);
+  program();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Cancel an alarm.
+    @param id Identifier of the alarm
+    @return True if the alarm was scheduled.
+*/
+/**************************************************************************/
+bool AlarmScheduler::remove(uint8_t id) {
+  for (uint8_t i = 0; i < size; i++) {
+    if (heap[i].id != id)
+      continue;
+    heap[i] = heap[--size];
+    if (i < size) {
+      siftUp(i);
+      siftDown(i);
+    }
+    program();
+    return true;
+  }
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the next alarm that is due.
+
+    If no alarm is known to be due, this reads the alarm flag of the chip,
+    and only reads the time if the flag is set. It should be called, until
+    it returns false, after the SQW/INT pin signaled an alarm, or from the
+    main loop. Single-shot alarms are removed from the queue as they are
+    returned, periodic ones are rescheduled.
+
+    @param[out] id Identifier of the alarm
+    @return True if an alarm is due, false otherwise.
+*/
+/**************************************************************************/
+bool AlarmScheduler::poll(uint8_t &id) {
+  if (!pending) {
+    if (!rtc.alarmFired(alarmNum))
+      return false;
+    rtc.clearAlarm(alarmNum);
+    due = rtc.now().unixtime();
+    pending = true;
+  }
+  if (!size || heap[0].time > due) {
+    pending = false;
+    program(true);
+    return pending && poll(id);
+  }
+  Entry &head = heap[0];
+  id = head.id;
+  if (head.period) {
+    head.time += head.period * ((due - head.time) / head.period + 1);
+  } else {
+    head = heap[--size];
+  }
+  siftDown(0);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Move an entry towards the root of the heap.
+    @param i Index of the entry
+*/
+/**************************************************************************/
+void AlarmScheduler::siftUp(uint8_t i) {
+  Entry entry = heap[i];
+  while (i) {
+    uint8_t parent = (i - 1) / 2;
+    if (heap[parent].time <= entry.time)
+      break;
+    heap[i] = heap[parent];
+    i = parent;
+  }
+  heap[i] = entry;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Move an entry towards the leaves of the heap.
+    @param i Index of the entry
+*/
+/**************************************************************************/
+void AlarmScheduler::siftDown(uint8_t i) {
+  if (i >= size)
+    return;
+  Entry entry = heap[i];
+  for (;;) {
+    uint16_t child = 2 * i + 1;
+    if (child >= size)
+      break;
+    if (child + 1 < size && heap[child + 1].time < heap[child].time)
+      child++;
+    if (entry.time <= heap[child].time)
+      break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  heap[i] = entry;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Program the earliest deadline into the chip, unless it is
+            already programmed. If that deadline has already passed, it is
+            flagged as due for the next poll().
+    @details The time is only read when the deadline may have passed
+        unnoticed: when it is earlier than the deadline it replaces, or
+        when the alarm just fired. A deadline that is not earlier than one
+        still ahead is ahead too, and if the one it replaces has passed,
+        the alarm flag is set and the next poll() reads the time.
+    @param fired True if the alarm fired and its flag was cleared
+*/
+/**************************************************************************/
+void AlarmScheduler::program(bool fired) {
+  if (!size) {
+    if (programmed) {
+      rtc.disableAlarm(alarmNum);
+      programmed = 0;
+    }
+    return;
+  }
+  uint32_t t = heap[0].time;
+  if (alarmNum == 2)
+    t = (t + 59) / 60 * 60; // alarm 2 has no seconds
+  if (t == programmed)
+    return;
+  if (alarmNum == 1)
+    rtc.setAlarm1(DateTime(t), DS3231_A1_Date);
+  else
+    rtc.setAlarm2(DateTime(t), DS3231_A2_Date);
+  bool mayHavePassed = fired || !programmed || t < programmed;
+  programmed = t;
+  if (heap[0].time <= due) {
+    pending = true; // already past at the last read of the time
+    return;
+  }
+  if (!mayHavePassed)
+    return;
+  due = rtc.now().unixtime();
+  if (heap[0].time <= due)
+    pending = true;
+}
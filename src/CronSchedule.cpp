@@ -0,0 +1,232 @@
+#include "RTClib.h"
+
+/**************************************************************************/
+/*!
+    @brief  Create a schedule matching every minute, like `* * * * *`.
+*/
+/**************************************************************************/
+CronSchedule::CronSchedule()
+    : seconds(1), minutes(0xFFFFFFFFFFFFFFFULL), hours(0xFFFFFF),
+      days(0x7FFFFFFF), months(0xFFF), weekdays(0x7F), anyDay(true),
+      anyWeekday(true) {}
+
+/**************************************************************************/
+/*!
+    @brief  Parse a decimal number of up to three digits.
+    @param[in,out] p String to parse, advanced past the number
+    @param[out] value Receives the number
+    @return True if there was a number.
+*/
+/**************************************************************************/
+static bool parseNumber(const char *&p, uint16_t &value) {
+  if (*p < '0' || *p > '9')
+    return false;
+  value = 0;
+  for (uint8_t i = 0; i < 3 && *p >= '0' && *p <= '9'; i++)
+    value = value * 10 + *p++ - '0';
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Parse one field of a cron expression.
+    @param p Field to parse
+    @param min Smallest allowed value
+    @param max Largest allowed value
+    @param[out] mask Receives the matching values, bit n being value n
+    @return Pointer past the field, or NULL if it is invalid.
+*/
+/**************************************************************************/
+const char *CronSchedule::parseField(const char *p, uint8_t min, uint8_t max,
+                                     uint64_t &mask) {
+  mask = 0;
+  for (;;) {
+    uint16_t first = min, last = max, step = 1;
+    if (*p == '*') {
+      p++;
+    } else {
+      if (!parseNumber(p, first))
+        return NULL;
+      if (*p == '-') {
+        p++;
+        if (!parseNumber(p, last))
+          return NULL;
+      } else if (*p != '/') { // "n/s" runs up to max
+        last = first;
+      }
+    }
+    if (*p == '/') {
+      p++;
+      if (!parseNumber(p, step))
+        return NULL;
+    }
+    if (first < min || last > max || first > last || step == 0)
+      return NULL;
+    for (uint16_t v = first; v <= last; v += step)
+      mask |= 1ULL << v;
+    if (*p != ',')
+      return p;
+    p++;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Compile a cron expression.
+    @param expression Five or six whitespace-separated fields, e.g.
+        `"0,30 9-17 * * 1-5"` or `"30 0 12 * * *"`.
+    @return True if the expression is valid. Otherwise the schedule is left
+        unchanged.
+*/
+/**************************************************************************/
+bool CronSchedule::begin(const char *expression) {
+  static const uint8_t limits[6][2] = {{0, 59}, {0, 59}, {0, 23},
+                                       {1, 31}, {1, 12}, {0, 7}};
+  uint8_t count = 0;
+  for (const char *p = expression; *p; p++) {
+    bool blank = *p == ' ' || *p == '\t';
+    if (!blank && (p == expression || p[-1] == ' ' || p[-1] == '\t'))
+      count++;
+  }
+  if (count < 5 || count > 6)
+    return false;
+
+  uint64_t masks[6] = {1}; // second 0 unless specified
+  bool star[6];
+  const char *p = expression;
+  for (uint8_t i = 6 - count; i < 6; i++) {
+    while (*p == ' ' || *p == '\t')
+      p++;
+    star[i] = *p == '*';
+    p = parseField(p, limits[i][0], limits[i][1], masks[i]);
+    if (!p || (*p && *p != ' ' && *p != '\t'))
+      return false;
+  }
+  seconds = masks[0];
+  minutes = masks[1];
+  hours = masks[2];
+  days = masks[3] >> 1;
+  months = masks[4] >> 1;
+  weekdays = (masks[5] | masks[5] >> 7) & 0x7F; // 7 is Sunday
+  anyDay = star[3];
+  anyWeekday = star[5];
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check whether a date matches the day fields of the schedule.
+    @param day Day of the month (1--31)
+    @param dow Day of the week (0--6, 0 being Sunday)
+    @return True if the date matches.
+*/
+/**************************************************************************/
+bool CronSchedule::matchDay(uint8_t day, uint8_t dow) const {
+  bool dayMatch = days >> (day - 1) & 1;
+  bool dowMatch = weekdays >> dow & 1;
+  if (anyDay || anyWeekday)
+    return dayMatch && dowMatch;
+  return dayMatch || dowMatch;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check whether a date and time matches the schedule.
+    @param dt Date and time to check
+    @return True if it matches.
+*/
+/**************************************************************************/
+bool CronSchedule::match(const DateTime &dt) const {
+  return (seconds >> dt.second() & 1) && (minutes >> dt.minute() & 1) &&
+         (hours >> dt.hour() & 1) && (months >> (dt.month() - 1) & 1) &&
+         matchDay(dt.day(), dt.dayOfTheWeek());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Find the first value at least `from` in a bitmask.
+    @param mask The bitmask
+    @param from Smallest value
+    @return The value, or -1 if there is none.
+*/
+/**************************************************************************/
+static int8_t nextBit(uint64_t mask, uint8_t from) {
+  mask >>= from;
+  if (!mask)
+    return -1;
+  while (!(mask & 1)) {
+    if (!(mask & 0xFF)) {
+      mask >>= 8;
+      from += 8;
+    } else {
+      mask >>= 1;
+      from++;
+    }
+  }
+  return from;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Find the next date and time matching the schedule.
+
+    The search skips whole months, days, hours and minutes that cannot
+    match, so it does not iterate over seconds.
+
+    @param after The result is strictly later than this time
+    @param[out] result Receives the next matching date and time
+    @return True if a match was found before the year 2100.
+*/
+/**************************************************************************/
+bool CronSchedule::next(const DateTime &after, DateTime &result) const {
+  DateTime t = after + TimeSpan(1);
+  uint16_t year = t.year();
+  uint8_t month = t.month(), day = t.day(), dow = t.dayOfTheWeek();
+  int8_t hour = t.hour(), minute = t.minute(), second = t.second();
+  for (;;) {
+    uint8_t monthDays =
+        month == 2 ? 28 + (year % 4 == 0)
+                   : 30 + ((month + (month >> 3)) & 1);
+    bool nextDay = !(months >> (month - 1) & 1);
+    if (nextDay) { // skip to the last day of the month
+      dow = (dow + monthDays - day) % 7;
+      day = monthDays;
+    } else if (!matchDay(day, dow)) {
+      nextDay = true;
+    } else {
+      int8_t h = nextBit(hours, hour);
+      if (h != hour)
+        minute = second = 0;
+      int8_t m = h < 0 ? -1 : nextBit(minutes, minute);
+      if (m != minute)
+        second = 0;
+      int8_t s = m < 0 ? -1 : nextBit(seconds, second);
+      if (s >= 0) {
+        result = DateTime(year, month, day, h, m, s);
+        return true;
+      }
+      if (m >= 0 && ++m < 60) { // try the next minute
+        hour = h;
+        minute = m;
+        second = 0;
+        continue;
+      }
+      if (h >= 0 && ++h < 24) { // try the next hour
+        hour = h;
+        minute = second = 0;
+        continue;
+      }
+      nextDay = true;
+    }
+    hour = minute = second = 0;
+    dow = (dow + 1) % 7;
+    if (++day > monthDays) {
+      day = 1;
+      if (++month > 12) {
+        month = 1;
+        if (++year > 2099)
+          return false;
+      }
+    }
+  }
+}
@@ -0,0 +1,207 @@
+#include "RTClib.h"
+
+/**************************************************************************/
+/*!
+    @brief  Given a date in the proleptic Gregorian calendar, return the
+            number of days since 1970-01-01.
+    @details Based on the `days_from_civil()` algorithm of Howard Hinnant,
+    http://howardhinnant.github.io/date_algorithms.html
+    @param y Year
+    @param m Month
+    @param d Day
+    @return Number of days, negative before 1970
+*/
+/**************************************************************************/
+static int32_t civil2days(int16_t y, uint8_t m, uint8_t d) {
+  int32_t year = y - (m <= 2);
+  int32_t era = (year >= 0 ? year : year - 399) / 400;
+  uint16_t yoe = year - era * 400; // year of era, 0--399
+  uint16_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1; // 0--365
+  uint32_t doe = yoe * 365UL + yoe / 4 - yoe / 100 + doy;         // 0--146096
+  return era * 146097 + (int32_t)doe - 719468;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Constructor from a 64-bit Unix time.
+    @details Based on the `civil_from_days()` algorithm of Howard Hinnant,
+    http://howardhinnant.github.io/date_algorithms.html
+    @param t Time elapsed in seconds since 1970-01-01 00:00:00, negative
+        for earlier times.
+*/
+/**************************************************************************/
+DateTime64::DateTime64(int64_t t) {
+  int32_t days = t / 86400;
+  int32_t secs = t % 86400;
+  if (secs < 0) { // round towards minus infinity
+    secs += 86400;
+    days--;
+  }
+  hh = secs / 3600;
+  mm = secs / 60 % 60;
+  ss = secs % 60;
+
+  days += 719468; // days since 0000-03-01
+  int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+  uint32_t doe = days - era * 146097; // day of era, 0--146096
+  uint16_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint16_t doy = doe - (yoe * 365UL + yoe / 4 - yoe / 100); // 0--365
+  uint8_t mp = (5 * doy + 2) / 153; // month starting from March, 0--11
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = yoe + era * 400 + (m <= 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Constructor from (year, month, day, hour, minute, second).
+    @warning If the provided parameters are not valid (e.g. 31 February),
+           the constructed DateTime64 will be invalid.
+    @param year Full year (1--9999).
+    @param month Month number (1--12).
+    @param day Day of the month (1--31).
+    @param hour,min,sec Hour (0--23), minute (0--59) and second (0--59).
+*/
+/**************************************************************************/
+DateTime64::DateTime64(int16_t year, uint8_t month, uint8_t day, uint8_t hour,
+                       uint8_t min, uint8_t sec)
+    : y(year), m(month), d(day), hh(hour), mm(min), ss(sec) {}
+
+/**************************************************************************/
+/*!
+    @brief  Constructor from a DateTime. The fields are copied as is.
+    @param dt DateTime to convert
+*/
+/**************************************************************************/
+DateTime64::DateTime64(const DateTime &dt)
+    : y(dt.year()), m(dt.month()), d(dt.day()), hh(dt.hour()),
+      mm(dt.minute()), ss(dt.second()) {}
+
+/**************************************************************************/
+/*!
+    @brief  Convert to a DateTime. The fields are copied as is.
+    @warning The result is only valid for years 2000--2099.
+    @return DateTime with the same fields.
+*/
+/**************************************************************************/
+DateTime DateTime64::toDateTime() const {
+  return DateTime(y - 2000, m, d, hh, mm, ss);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check whether this DateTime64 is valid.
+    @return true if valid, false if not.
+*/
+/**************************************************************************/
+bool DateTime64::isValid() const {
+  if (y < 1 || y > 9999 || m < 1 || m > 12 || d < 1 || hh > 23 || mm > 59 ||
+      ss > 59)
+    return false;
+  bool leap = y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+  uint8_t monthDays = m == 2 ? 28 + leap : 30 + ((m + (m >> 3)) & 1);
+  return d <= monthDays;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Return the day of the week.
+    @return Day of week as an integer from 0 (Sunday) to 6 (Saturday).
+*/
+/**************************************************************************/
+uint8_t DateTime64::dayOfTheWeek() const {
+  int32_t days = civil2days(y, m, d);
+  return days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6; // 1970-01-01: Thu
+}
+
+/**************************************************************************/
+/*!
+    @brief  Return the 64-bit Unix time: seconds since 1 Jan 1970.
+    @return Number of seconds since 1970-01-01 00:00:00, negative for
+        earlier times.
+*/
+/**************************************************************************/
+int64_t DateTime64::unixtime() const {
+  return civil2days(y, m, d) * (int64_t)86400 + hh * 3600L + mm * 60 + ss;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Add a TimeSpan64 to the DateTime64 object
+    @param span TimeSpan64 object
+    @return New DateTime64 object with span added to it.
+*/
+/**************************************************************************/
+DateTime64 DateTime64::operator+(const TimeSpan64 &span) const {
+  return DateTime64(unixtime() + span.totalseconds());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Subtract a TimeSpan64 from the DateTime64 object
+    @param span TimeSpan64 object
+    @return New DateTime64 object with span subtracted from it.
+*/
+/**************************************************************************/
+DateTime64 DateTime64::operator-(const TimeSpan64 &span) const {
+  return DateTime64(unixtime() - span.totalseconds());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Subtract one DateTime64 from another
+    @param right The DateTime64 object to subtract from self
+    @return TimeSpan64 of the difference, negative if `right` is later.
+*/
+/**************************************************************************/
+TimeSpan64 DateTime64::operator-(const DateTime64 &right) const {
+  return TimeSpan64(unixtime() - right.unixtime());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Test if one DateTime64 is less (earlier) than another.
+    @param right Comparison DateTime64 object
+    @return True if the left DateTime64 is earlier than the right one.
+*/
+/**************************************************************************/
+bool DateTime64::operator<(const DateTime64 &right) const {
+  if (y != right.y)
+    return y < right.y;
+  if (m != right.m)
+    return m < right.m;
+  if (d != right.d)
+    return d < right.d;
+  if (hh != right.hh)
+    return hh < right.hh;
+  if (mm != right.mm)
+    return mm < right.mm;
+  return ss < right.ss;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Test if two DateTime64 objects are equal.
+    @param right Comparison DateTime64 object
+    @return True if both DateTime64 objects are the same, false otherwise.
+*/
+/**************************************************************************/
+bool DateTime64::operator==(const DateTime64 &right) const {
+  return y == right.y && m == right.m && d == right.d && hh == right.hh &&
+         mm == right.mm && ss == right.ss;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Create a TimeSpan64 from a number of days, hours, minutes and
+            seconds.
+    @param days Number of days
+    @param hours Number of hours
+    @param minutes Number of minutes
+    @param seconds Number of seconds
+*/
+/**************************************************************************/
+TimeSpan64::TimeSpan64(int32_t days, int8_t hours, int8_t minutes,
+                       int8_t seconds)
+    : _seconds((int64_t)days * 86400 + (int32_t)hours * 3600 +
+               (int32_t)minutes * 60 + seconds) {}
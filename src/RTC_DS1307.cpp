@@ -12,12 +12,7 @@
 */
 /**************************************************************************/
 bool RTC_DS1307::begin(TwoWire *wireInstance) {
-  if (i2c_dev)
-    delete i2c_dev;
-  i2c_dev = new Adafruit_I2CDevice(DS1307_ADDRESS, wireInstance);
-  if (!i2c_dev->begin())
-    return false;
-  return true;
+  return beginDevice(DS1307_ADDRESS, wireInstance);
 }
 
 /**************************************************************************/
@@ -28,6 +23,15 @@ bool RTC_DS1307::begin(TwoWire *wireInstance) {
 /**************************************************************************/
 uint8_t RTC_DS1307::isrunning(void) { return !(read_register(0) >> 7); }
 
+/**************************************************************************/
+/*!
+    @brief  Check whether the DS1307 lost power, by checking the Clock Halt
+            bit, which is set when the chip powers up without a battery
+    @return True if the clock is halted, false once adjust() started it
+*/
+/**************************************************************************/
+bool RTC_DS1307::lostPower(void) { return !isrunning(); }
+
 /**************************************************************************/
 /*!
     @brief  Set the date and time in the DS1307
@@ -35,14 +39,8 @@ uint8_t RTC_DS1307::isrunning(void) { return !(read_register(0) >> 7); }
 */
 /**************************************************************************/
 void RTC_DS1307::adjust(const DateTime &dt) {
-  uint8_t buffer[8] = {0,
-                       bin2bcd(dt.second()),
-                       bin2bcd(dt.minute()),
-                       bin2bcd(dt.hour()),
-                       0,
-                       bin2bcd(dt.day()),
-                       bin2bcd(dt.month()),
-                       bin2bcd(dt.year() - 2000U)};
+  uint8_t buffer[8] = {0};
+  encodeTime(dt, buffer + 1);
   i2c_dev->write(buffer, 8);
 }
 
@@ -57,9 +55,88 @@ DateTime RTC_DS1307::now() {
   buffer[0] = 0;
   i2c_dev->write_then_read(buffer, 1, buffer, 7);
 
-  return DateTime(bcd2bin(buffer[6]) + 2000U, bcd2bin(buffer[5]),
-                  bcd2bin(buffer[4]), bcd2bin(buffer[2]), bcd2bin(buffer[1]),
-                  bcd2bin(buffer[0] & 0x7F));
+  return decodeTime(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start reading the date and time without blocking.
+    @details The reading is carried out by calling pollNow() until it
+    returns true. The DS1307 must not be accessed otherwise in the meantime.
+*/
+/**************************************************************************/
+void RTC_DS1307::requestNow(void) { startRead(0, 7); }
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a reading started by requestNow().
+    @details Each call does at most one short I2C transaction.
+    @param[out] dt Receives the date and time once the reading completes
+    @return True if the reading completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_DS1307::pollNow(DateTime &dt) {
+  if (!stepTransfer())
+    return false;
+  dt = decodeTime(transferBuffer);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start setting the date and time without blocking.
+    @details The setting is carried out by calling pollAdjust() until it
+    returns true. The DS1307 must not be accessed otherwise in the meantime.
+    @param dt DateTime object containing the desired date/time
+*/
+/**************************************************************************/
+void RTC_DS1307::requestAdjust(const DateTime &dt) {
+  uint8_t buffer[7];
+  encodeTime(dt, buffer);
+  startWrite(0, buffer, 7);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a setting started by requestAdjust().
+    @details Writes all the time registers in a single I2C transaction:
+    written in pieces, they could tear if the seconds rolled over in
+    between.
+    @return True if the setting completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_DS1307::pollAdjust(void) { return stepTransfer(); }
+
+/**************************************************************************/
+/*!
+    @brief  Decode the time registers of the DS1307.
+    @param regs Contents of registers 0x00 to 0x06
+    @return Decoded date and time.
+*/
+/**************************************************************************/
+DateTime RTC_DS1307::decodeTime(const uint8_t *regs) {
+  return DateTime(bcd2bin(regs[6]) + 2000U, bcd2bin(regs[5]),
+                  bcd2bin(regs[4]), bcd2bin(regs[2]), bcd2bin(regs[1]),
+                  bcd2bin(regs[0] & 0x7F));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encode a date and time into the time registers of the DS1307.
+    @param dt Date and time to encode
+    @param[out] regs Receives the contents of registers 0x00 to 0x06
+*/
+/**************************************************************************/
+void RTC_DS1307::encodeTime(const DateTime &dt, uint8_t *regs) {
+  regs[0] = bin2bcd(dt.second());
+  regs[1] = bin2bcd(dt.minute());
+  regs[2] = bin2bcd(dt.hour());
+  regs[3] = 0;
+  regs[4] = bin2bcd(dt.day());
+  regs[5] = bin2bcd(dt.month());
+  regs[6] = bin2bcd(dt.year() - 2000U);
 }
 
 /**************************************************************************/
@@ -6,6 +6,7 @@
 #define DS3231_ALARM2 0x0B    ///< Alarm 2 register
 #define DS3231_CONTROL 0x0E   ///< Control register
 #define DS3231_STATUSREG 0x0F ///< Status register
+#define DS3231_AGINGREG 0x10  ///< Aging offset register
 #define DS3231_TEMPERATUREREG                                                  \
   0x11 ///< Temperature register (high byte - low byte is at 0x12), 10-bit
        ///< temperature value
@@ -18,14 +19,91 @@
 */
 /**************************************************************************/
 bool RTC_DS3231::begin(TwoWire *wireInstance) {
-  if (i2c_dev)
-    delete i2c_dev;
-  i2c_dev = new Adafruit_I2CDevice(DS3231_ADDRESS, wireInstance);
-  if (!i2c_dev->begin())
+  if (!beginDevice(DS3231_ADDRESS, wireInstance))
     return false;
+  if (registerCache)
+    enableRegisterCache(); // reload, the cache may be stale
   return true;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Keep a copy of the CONTROL register and of the EN32kHz bit of the
+            STATUS register in RAM.
+    @details Once enabled, the configuration methods (writeSqwPinMode(),
+    setAlarm1(), setAlarm2(), disableAlarm(), clearAlarm(), enable32K(),
+    disable32K() and adjust()) no longer read those registers before writing
+    them, which halves their I2C traffic. readSqwPinMode() and isEnabled32K()
+    are served from the cache without any bus access. The OSF, A1F and A2F
+    flags are still read from the chip, as the chip can set them at any time.
+
+    The cache is loaded from the chip by this method, which should then be
+    called after begin(). It is only valid as long as nothing else on the
+    bus writes the CONTROL or STATUS registers.
+*/
+/**************************************************************************/
+void RTC_DS3231::enableRegisterCache(void) {
+  uint8_t buffer[2] = {DS3231_CONTROL, 0};
+  i2c_dev->write_then_read(buffer, 1, buffer, 2);
+  controlCache = buffer[0] & ~0x20; // CONV is cleared by the chip
+  statusCache = buffer[1] & 0x08;   // EN32kHz
+  registerCache = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Go back to reading the CONTROL and STATUS registers from the chip
+            before every update.
+*/
+/**************************************************************************/
+void RTC_DS3231::disableRegisterCache(void) { registerCache = false; }
+
+/**************************************************************************/
+/*!
+    @brief  Read the CONTROL register, from the cache if enabled
+    @return Value of the CONTROL register
+*/
+/**************************************************************************/
+uint8_t RTC_DS3231::readControl(void) {
+  if (registerCache)
+    return controlCache;
+  return read_register(DS3231_CONTROL);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Write the CONTROL register, updating the cache
+    @param ctrl New value of the CONTROL register
+*/
+/**************************************************************************/
+void RTC_DS3231::writeControl(uint8_t ctrl) {
+  controlCache = ctrl & ~0x20; // CONV is cleared by the chip
+  write_register(DS3231_CONTROL, ctrl);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Update some bits of the STATUS register
+    @details Without the cache, this is a read-modify-write. With the cache,
+    the OSF, A2F and A1F flags that are not being updated are written as 1,
+    which leaves them unchanged: the chip only allows clearing them. The
+    EN32kHz bit comes from the cache, so no read is needed.
+    @param mask Bits to update
+    @param value New value of these bits
+*/
+/**************************************************************************/
+void RTC_DS3231::updateStatus(uint8_t mask, uint8_t value) {
+  uint8_t status;
+  if (registerCache) {
+    statusCache = ((statusCache & ~mask) | value) & 0x08;
+    status = statusCache | (0x83 & ~mask) | (value & 0x83);
+  } else {
+    status = read_register(DS3231_STATUSREG);
+    status = (status & ~mask) | value;
+  }
+  write_register(DS3231_STATUSREG, status);
+}
+
 /**************************************************************************/
 /*!
     @brief  Check the status register Oscillator Stop Flag to see if the DS3231
@@ -45,19 +123,11 @@ bool RTC_DS3231::lostPower(void) {
 */
 /**************************************************************************/
 void RTC_DS3231::adjust(const DateTime &dt) {
-  uint8_t buffer[8] = {DS3231_TIME,
-                       bin2bcd(dt.second()),
-                       bin2bcd(dt.minute()),
-                       bin2bcd(dt.hour()),
-                       bin2bcd(dowToDS3231(dt.dayOfTheWeek())),
-                       bin2bcd(dt.day()),
-                       bin2bcd(dt.month()),
-                       bin2bcd(dt.year() - 2000U)};
+  uint8_t buffer[8] = {DS3231_TIME};
+  encodeTime(dt, buffer + 1);
   i2c_dev->write(buffer, 8);
 
-  uint8_t statreg = read_register(DS3231_STATUSREG);
-  statreg &= ~0x80; // flip OSF bit
-  write_register(DS3231_STATUSREG, statreg);
+  updateStatus(0x80, 0); // flip OSF bit
 }
 
 /**************************************************************************/
@@ -71,9 +141,94 @@ DateTime RTC_DS3231::now() {
   buffer[0] = 0;
   i2c_dev->write_then_read(buffer, 1, buffer, 7);
 
-  return DateTime(bcd2bin(buffer[6]) + 2000U, bcd2bin(buffer[5] & 0x7F),
-                  bcd2bin(buffer[4]), bcd2bin(buffer[2]), bcd2bin(buffer[1]),
-                  bcd2bin(buffer[0] & 0x7F));
+  return decodeTime(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start reading the date/time without blocking.
+    @details The reading is carried out by calling pollNow() until it
+    returns true. The DS3231 must not be accessed otherwise in the meantime.
+*/
+/**************************************************************************/
+void RTC_DS3231::requestNow(void) { startRead(DS3231_TIME, 7); }
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a reading started by requestNow().
+    @details Each call does at most one short I2C transaction.
+    @param[out] dt Receives the date/time once the reading completes
+    @return True if the reading completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_DS3231::pollNow(DateTime &dt) {
+  if (!stepTransfer())
+    return false;
+  dt = decodeTime(transferBuffer);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start setting the date/time without blocking.
+    @details The setting is carried out by calling pollAdjust() until it
+    returns true. The DS3231 must not be accessed otherwise in the meantime.
+    @param dt DateTime object containing the date/time to set
+*/
+/**************************************************************************/
+void RTC_DS3231::requestAdjust(const DateTime &dt) {
+  uint8_t buffer[7];
+  encodeTime(dt, buffer);
+  startWrite(DS3231_TIME, buffer, 7);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a setting started by requestAdjust().
+    @details Writes all the time registers in a single I2C transaction, then
+    clears the Oscillator Stop Flag. Written in pieces, the time registers
+    could tear if the seconds rolled over in between.
+    @return True if the setting completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_DS3231::pollAdjust(void) {
+  if (!stepTransfer())
+    return false;
+  updateStatus(0x80, 0); // flip OSF bit
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the date/time registers
+    @param regs Contents of the registers, starting at DS3231_TIME
+    @return DateTime object with the date/time
+*/
+/**************************************************************************/
+DateTime RTC_DS3231::decodeTime(const uint8_t *regs) {
+  return DateTime(bcd2bin(regs[6]) + 2000U, bcd2bin(regs[5] & 0x7F),
+                  bcd2bin(regs[4]), bcd2bin(regs[2]), bcd2bin(regs[1]),
+                  bcd2bin(regs[0] & 0x7F));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encode a date/time into the date/time registers
+    @param dt DateTime object with the date/time
+    @param[out] regs Receives the contents of the registers, starting at
+        DS3231_TIME
+*/
+/**************************************************************************/
+void RTC_DS3231::encodeTime(const DateTime &dt, uint8_t *regs) {
+  regs[0] = bin2bcd(dt.second());
+  regs[1] = bin2bcd(dt.minute());
+  regs[2] = bin2bcd(dt.hour());
+  regs[3] = bin2bcd(dowToDS3231(dt.dayOfTheWeek()));
+  regs[4] = bin2bcd(dt.day());
+  regs[5] = bin2bcd(dt.month());
+  regs[6] = bin2bcd(dt.year() - 2000U);
 }
 
 /**************************************************************************/
@@ -83,8 +238,19 @@ DateTime RTC_DS3231::now() {
 */
 /**************************************************************************/
 Ds3231SqwPinMode RTC_DS3231::readSqwPinMode() {
+  return decodeSqwPinMode(readControl());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the SQW pin mode
+    @param ctrl Value of the control register
+    @return Pin mode, see Ds3231SqwPinMode enum
+*/
+/**************************************************************************/
+Ds3231SqwPinMode RTC_DS3231::decodeSqwPinMode(uint8_t ctrl) {
   int mode;
-  mode = read_register(DS3231_CONTROL) & 0x1C;
+  mode = ctrl & 0x1C;
   if (mode & 0x04)
     mode = DS3231_OFF;
   return static_cast<Ds3231SqwPinMode>(mode);
@@ -97,12 +263,12 @@ Ds3231SqwPinMode RTC_DS3231::readSqwPinMode() {
 */
 /**************************************************************************/
 void RTC_DS3231::writeSqwPinMode(Ds3231SqwPinMode mode) {
-  uint8_t ctrl = read_register(DS3231_CONTROL);
+  uint8_t ctrl = readControl();
 
   ctrl &= ~0x04; // turn off INTCON
   ctrl &= ~0x18; // set freq bits to 0
 
-  write_register(DS3231_CONTROL, ctrl | mode);
+  writeControl(ctrl | mode);
 }
 
 /**************************************************************************/
@@ -114,7 +280,110 @@ void RTC_DS3231::writeSqwPinMode(Ds3231SqwPinMode mode) {
 float RTC_DS3231::getTemperature() {
   uint8_t buffer[2] = {DS3231_TEMPERATUREREG, 0};
   i2c_dev->write_then_read(buffer, 1, buffer, 2);
-  return (float)buffer[0] + (buffer[1] >> 6) * 0.25f;
+  return decodeTemperature(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read the aging offset register
+    @return Aging offset, from -128 to 127. Each step changes the frequency
+        by about 0.1 ppm, a positive offset slowing the clock down.
+*/
+/**************************************************************************/
+int8_t RTC_DS3231::readAgingOffset(void) {
+  return (int8_t)read_register(DS3231_AGINGREG);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Write the aging offset register
+    @details The new offset takes effect at the next temperature conversion,
+    which the chip does every 64 seconds, or which forceConversion()
+    triggers.
+    @param offset Aging offset, from -128 to 127. A positive offset slows
+        the clock down.
+*/
+/**************************************************************************/
+void RTC_DS3231::writeAgingOffset(int8_t offset) {
+  write_register(DS3231_AGINGREG, (uint8_t)offset);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start a temperature conversion, which also applies the aging
+            offset to the oscillator
+    @param wait Whether to wait, for up to 300 ms, until the conversion is
+        done
+    @return False if a conversion was already in progress, or if the
+        conversion did not complete in time.
+*/
+/**************************************************************************/
+bool RTC_DS3231::forceConversion(bool wait) {
+  if (read_register(DS3231_STATUSREG) & 0x04) // BSY
+    return false;
+  writeControl(readControl() | 0x20); // CONV
+  if (!wait)
+    return true;
+  uint32_t start = millis();
+  while (read_register(DS3231_CONTROL) & 0x20) {
+    if (millis() - start > 300)
+      return false;
+    delay(1);
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the temperature registers
+    @param regs Contents of the registers, starting at DS3231_TEMPERATUREREG
+    @return Temperature (float)
+*/
+/**************************************************************************/
+float RTC_DS3231::decodeTemperature(const uint8_t *regs) {
+  return (float)regs[0] + (regs[1] >> 6) * 0.25f;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read all the registers of the DS3231 in a single I2C transaction
+    @details This is equivalent to calling now(), getAlarm1(),
+    getAlarm1Mode(), getAlarm2(), getAlarm2Mode(), readSqwPinMode(),
+    lostPower(), alarmFired(), isEnabled32K() and getTemperature(), but it
+    only addresses the chip once. If the register cache is enabled, it is
+    refreshed with the values read.
+    @return Ds3231Snapshot with the decoded register contents
+*/
+/**************************************************************************/
+Ds3231Snapshot RTC_DS3231::getSnapshot() {
+  uint8_t buffer[19];
+  buffer[0] = DS3231_TIME;
+  i2c_dev->write_then_read(buffer, 1, buffer, 19);
+
+  uint8_t ctrl = buffer[DS3231_CONTROL];
+  uint8_t status = buffer[DS3231_STATUSREG];
+  if (registerCache) {
+    controlCache = ctrl & ~0x20; // CONV is cleared by the chip
+    statusCache = status & 0x08; // EN32kHz
+  }
+
+  Ds3231Snapshot snapshot;
+  snapshot.now = decodeTime(buffer + DS3231_TIME);
+  snapshot.alarm1 = decodeAlarm1(buffer + DS3231_ALARM1);
+  snapshot.alarm1Mode = decodeAlarm1Mode(buffer + DS3231_ALARM1);
+  snapshot.alarm2 = decodeAlarm2(buffer + DS3231_ALARM2);
+  snapshot.alarm2Mode = decodeAlarm2Mode(buffer + DS3231_ALARM2);
+  snapshot.sqwPinMode = decodeSqwPinMode(ctrl);
+  snapshot.alarm1Enabled = ctrl & 0x01;
+  snapshot.alarm2Enabled = (ctrl >> 1) & 0x01;
+  snapshot.lostPower = status >> 7;
+  snapshot.busy = (status >> 2) & 0x01;
+  snapshot.alarm1Fired = status & 0x01;
+  snapshot.alarm2Fired = (status >> 1) & 0x01;
+  snapshot.enabled32K = (status >> 3) & 0x01;
+  snapshot.agingOffset = (int8_t)buffer[DS3231_AGINGREG];
+  snapshot.temperature = decodeTemperature(buffer + DS3231_TEMPERATUREREG);
+  return snapshot;
 }
 
 /**************************************************************************/
@@ -126,7 +395,7 @@ float RTC_DS3231::getTemperature() {
 */
 /**************************************************************************/
 bool RTC_DS3231::setAlarm1(const DateTime &dt, Ds3231Alarm1Mode alarm_mode) {
-  uint8_t ctrl = read_register(DS3231_CONTROL);
+  uint8_t ctrl = readControl();
   if (!(ctrl & 0x04)) {
     return false;
   }
@@ -145,7 +414,7 @@ bool RTC_DS3231::setAlarm1(const DateTime &dt, Ds3231Alarm1Mode alarm_mode) {
                        uint8_t(bin2bcd(day) | A1M4 | DY_DT)};
   i2c_dev->write(buffer, 5);
 
-  write_register(DS3231_CONTROL, ctrl | 0x01); // AI1E
+  writeControl(ctrl | 0x01); // AI1E
 
   return true;
 }
@@ -159,7 +428,7 @@ bool RTC_DS3231::setAlarm1(const DateTime &dt, Ds3231Alarm1Mode alarm_mode) {
 */
 /**************************************************************************/
 bool RTC_DS3231::setAlarm2(const DateTime &dt, Ds3231Alarm2Mode alarm_mode) {
-  uint8_t ctrl = read_register(DS3231_CONTROL);
+  uint8_t ctrl = readControl();
   if (!(ctrl & 0x04)) {
     return false;
   }
@@ -176,7 +445,7 @@ bool RTC_DS3231::setAlarm2(const DateTime &dt, Ds3231Alarm2Mode alarm_mode) {
                        uint8_t(bin2bcd(day) | A2M4 | DY_DT)};
   i2c_dev->write(buffer, 4);
 
-  write_register(DS3231_CONTROL, ctrl | 0x02); // AI2E
+  writeControl(ctrl | 0x02); // AI2E
 
   return true;
 }
@@ -192,25 +461,37 @@ DateTime RTC_DS3231::getAlarm1() {
   uint8_t buffer[5] = {DS3231_ALARM1, 0, 0, 0, 0};
   i2c_dev->write_then_read(buffer, 1, buffer, 5);
 
-  uint8_t seconds = bcd2bin(buffer[0] & 0x7F);
-  uint8_t minutes = bcd2bin(buffer[1] & 0x7F);
+  return decodeAlarm1(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the Alarm1 registers
+    @param regs Contents of the registers, starting at DS3231_ALARM1
+    @return DateTime object with the Alarm1 data set in the
+            day, hour, minutes, and seconds fields
+*/
+/**************************************************************************/
+DateTime RTC_DS3231::decodeAlarm1(const uint8_t *regs) {
+  uint8_t seconds = bcd2bin(regs[0] & 0x7F);
+  uint8_t minutes = bcd2bin(regs[1] & 0x7F);
   // Fetching the hour assumes 24 hour time (never 12)
   // because this library exclusively stores the time
   // in 24 hour format. Note that the DS3231 supports
   // 12 hour storage, and sets bits to indicate the type
   // that is stored.
-  uint8_t hour = bcd2bin(buffer[2] & 0x3F);
+  uint8_t hour = bcd2bin(regs[2] & 0x3F);
 
   // Determine if the alarm is set to fire based on the
   // day of the week, or an explicit date match.
-  bool isDayOfWeek = (buffer[3] & 0x40) >> 6;
+  bool isDayOfWeek = (regs[3] & 0x40) >> 6;
   uint8_t day;
   if (isDayOfWeek) {
     // Alarm set to match on day of the week
-    day = bcd2bin(buffer[3] & 0x0F);
+    day = bcd2bin(regs[3] & 0x0F);
   } else {
     // Alarm set to match on day of the month
-    day = bcd2bin(buffer[3] & 0x3F);
+    day = bcd2bin(regs[3] & 0x3F);
   }
 
   // On the first week of May 2000, the day-of-the-week number
@@ -229,24 +510,36 @@ DateTime RTC_DS3231::getAlarm2() {
   uint8_t buffer[4] = {DS3231_ALARM2, 0, 0, 0};
   i2c_dev->write_then_read(buffer, 1, buffer, 4);
 
-  uint8_t minutes = bcd2bin(buffer[0] & 0x7F);
+  return decodeAlarm2(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the Alarm2 registers
+    @param regs Contents of the registers, starting at DS3231_ALARM2
+    @return DateTime object with the Alarm2 data set in the
+            day, hour, and minutes fields
+*/
+/**************************************************************************/
+DateTime RTC_DS3231::decodeAlarm2(const uint8_t *regs) {
+  uint8_t minutes = bcd2bin(regs[0] & 0x7F);
   // Fetching the hour assumes 24 hour time (never 12)
   // because this library exclusively stores the time
   // in 24 hour format. Note that the DS3231 supports
   // 12 hour storage, and sets bits to indicate the type
   // that is stored.
-  uint8_t hour = bcd2bin(buffer[1] & 0x3F);
+  uint8_t hour = bcd2bin(regs[1] & 0x3F);
 
   // Determine if the alarm is set to fire based on the
   // day of the week, or an explicit date match.
-  bool isDayOfWeek = (buffer[2] & 0x40) >> 6;
+  bool isDayOfWeek = (regs[2] & 0x40) >> 6;
   uint8_t day;
   if (isDayOfWeek) {
     // Alarm set to match on day of the week
-    day = bcd2bin(buffer[2] & 0x0F);
+    day = bcd2bin(regs[2] & 0x0F);
   } else {
     // Alarm set to match on day of the month
-    day = bcd2bin(buffer[2] & 0x3F);
+    day = bcd2bin(regs[2] & 0x3F);
   }
 
   // On the first week of May 2000, the day-of-the-week number
@@ -264,11 +557,22 @@ Ds3231Alarm1Mode RTC_DS3231::getAlarm1Mode() {
   uint8_t buffer[5] = {DS3231_ALARM1, 0, 0, 0, 0};
   i2c_dev->write_then_read(buffer, 1, buffer, 5);
 
-  uint8_t alarm_mode = (buffer[0] & 0x80) >> 7    // A1M1 - Seconds bit
-                       | (buffer[1] & 0x80) >> 6  // A1M2 - Minutes bit
-                       | (buffer[2] & 0x80) >> 5  // A1M3 - Hour bit
-                       | (buffer[3] & 0x80) >> 4  // A1M4 - Day/Date bit
-                       | (buffer[3] & 0x40) >> 2; // DY_DT
+  return decodeAlarm1Mode(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the mode of Alarm1
+    @param regs Contents of the registers, starting at DS3231_ALARM1
+    @return Ds3231Alarm1Mode enum value for the Alarm1 mode
+*/
+/**************************************************************************/
+Ds3231Alarm1Mode RTC_DS3231::decodeAlarm1Mode(const uint8_t *regs) {
+  uint8_t alarm_mode = (regs[0] & 0x80) >> 7    // A1M1 - Seconds bit
+                       | (regs[1] & 0x80) >> 6  // A1M2 - Minutes bit
+                       | (regs[2] & 0x80) >> 5  // A1M3 - Hour bit
+                       | (regs[3] & 0x80) >> 4  // A1M4 - Day/Date bit
+                       | (regs[3] & 0x40) >> 2; // DY_DT
 
   // Determine which mode the fetched alarm bits map to
   switch (alarm_mode) {
@@ -295,10 +599,21 @@ Ds3231Alarm2Mode RTC_DS3231::getAlarm2Mode() {
   uint8_t buffer[4] = {DS3231_ALARM2, 0, 0, 0};
   i2c_dev->write_then_read(buffer, 1, buffer, 4);
 
-  uint8_t alarm_mode = (buffer[0] & 0x80) >> 7    // A2M2 - Minutes bit
-                       | (buffer[1] & 0x80) >> 6  // A2M3 - Hour bit
-                       | (buffer[2] & 0x80) >> 5  // A2M4 - Day/Date bit
-                       | (buffer[2] & 0x40) >> 3; // DY_DT
+  return decodeAlarm2Mode(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the mode of Alarm2
+    @param regs Contents of the registers, starting at DS3231_ALARM2
+    @return Ds3231Alarm2Mode enum value for the Alarm2 mode
+*/
+/**************************************************************************/
+Ds3231Alarm2Mode RTC_DS3231::decodeAlarm2Mode(const uint8_t *regs) {
+  uint8_t alarm_mode = (regs[0] & 0x80) >> 7    // A2M2 - Minutes bit
+                       | (regs[1] & 0x80) >> 6  // A2M3 - Hour bit
+                       | (regs[2] & 0x80) >> 5  // A2M4 - Day/Date bit
+                       | (regs[2] & 0x40) >> 3; // DY_DT
 
   // Determine which mode the fetched alarm bits map to
   switch (alarm_mode) {
@@ -321,9 +636,9 @@ Ds3231Alarm2Mode RTC_DS3231::getAlarm2Mode() {
 */
 /**************************************************************************/
 void RTC_DS3231::disableAlarm(uint8_t alarm_num) {
-  uint8_t ctrl = read_register(DS3231_CONTROL);
+  uint8_t ctrl = readControl();
   ctrl &= ~(1 << (alarm_num - 1));
-  write_register(DS3231_CONTROL, ctrl);
+  writeControl(ctrl);
 }
 
 /**************************************************************************/
@@ -333,9 +648,7 @@ void RTC_DS3231::disableAlarm(uint8_t alarm_num) {
 */
 /**************************************************************************/
 void RTC_DS3231::clearAlarm(uint8_t alarm_num) {
-  uint8_t status = read_register(DS3231_STATUSREG);
-  status &= ~(0x1 << (alarm_num - 1));
-  write_register(DS3231_STATUSREG, status);
+  updateStatus(0x1 << (alarm_num - 1), 0);
 }
 
 /**************************************************************************/
@@ -357,9 +670,7 @@ bool RTC_DS3231::alarmFired(uint8_t alarm_num) {
 */
 /**************************************************************************/
 void RTC_DS3231::enable32K(void) {
-  uint8_t status = read_register(DS3231_STATUSREG);
-  status |= (0x1 << 0x03);
-  write_register(DS3231_STATUSREG, status);
+  updateStatus(0x1 << 0x03, 0x1 << 0x03);
 }
 
 /**************************************************************************/
@@ -368,9 +679,7 @@ void RTC_DS3231::enable32K(void) {
 */
 /**************************************************************************/
 void RTC_DS3231::disable32K(void) {
-  uint8_t status = read_register(DS3231_STATUSREG);
-  status &= ~(0x1 << 0x03);
-  write_register(DS3231_STATUSREG, status);
+  updateStatus(0x1 << 0x03, 0);
 }
 
 /**************************************************************************/
@@ -380,5 +689,31 @@ void RTC_DS3231::disable32K(void) {
 */
 /**************************************************************************/
 bool RTC_DS3231::isEnabled32K(void) {
+  if (registerCache)
+    return (statusCache >> 0x03) & 0x01;
   return (read_register(DS3231_STATUSREG) >> 0x03) & 0x01;
 }
+
+/**************************************************************************/
+/*!
+    @brief  Compute and write the aging offset cancelling the measured
+            drift, apply it, then start a new measurement.
+    @param rtc The RTC to trim
+    @return False if fewer than two samples spanning some time were added.
+*/
+/**************************************************************************/
+bool Ds3231AgingTrim::apply(RTC_DS3231 &rtc) {
+  if (count < 2 || sumXX <= 0)
+    return false;
+  // About 0.1 ppm per step, a positive offset slowing the clock down
+  float target = rtc.readAgingOffset() + drift() * 10;
+  int8_t value = target >= 127    ? 127
+                 : target <= -128 ? -128
+                 : target < 0     ? (int8_t)(target - 0.5f)
+                                  : (int8_t)(target + 0.5f);
+  rtc.writeAgingOffset(value);
+  rtc.forceConversion();
+  residualPpm = (target - value) * 0.1f;
+  reset();
+  return true;
+}
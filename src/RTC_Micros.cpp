@@ -11,13 +11,69 @@ void RTC_Micros::adjust(const DateTime &dt) {
   lastUnix = dt.unixtime();
 }
 
+/**************************************************************************/
+/*!
+    @brief  Set the current date/time of the RTC_Micros clock, including
+            the fraction of a second.
+    @param dt PreciseDateTime object with the desired date and time
+*/
+/**************************************************************************/
+void RTC_Micros::adjust(const PreciseDateTime &dt) {
+  lastMicros = micros() - dt.microsecond();
+  lastUnix = dt.unixtime();
+}
+
 /**************************************************************************/
 /*!
     @brief  Adjust the RTC_Micros clock to compensate for system clock drift
     @param ppm Adjustment to make. A positive adjustment makes the clock faster.
 */
 /**************************************************************************/
-void RTC_Micros::adjustDrift(int ppm) { microsPerSecond = 1000000 - ppm; }
+void RTC_Micros::adjustDrift(int ppm) {
+  microsPerSecond = 1000000 - ppm;
+  microsFraction = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adjust the RTC_Micros clock to compensate for system clock
+            drift, with a resolution finer than one ppm.
+    @param ppb Adjustment to make, in parts per billion, within
+        &plusmn;50,000,000. A positive adjustment makes the clock faster.
+*/
+/**************************************************************************/
+void RTC_Micros::adjustDriftPpb(int32_t ppb) {
+  // Microseconds per second in units of 1/65536 us, rounded down. Beyond
+  // 32,768 ppm the offset no longer fits in 32 bits.
+  int64_t offset = -((int64_t)ppb * 65536 / 1000);
+  microsPerSecond = 1000000 + (int32_t)(offset >> 16);
+  microsFraction = (uint16_t)(offset & 0xFFFF);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Advance `lastUnix` and `lastMicros` to the last full second.
+    @return Number of `micros()` ticks elapsed since that second.
+*/
+/**************************************************************************/
+uint32_t RTC_Micros::advance() {
+  uint32_t elapsed = micros() - lastMicros;
+  uint32_t elapsedSeconds = elapsed / microsPerSecond;
+  uint32_t ticks = elapsedSeconds * microsPerSecond;
+  uint32_t accumulator = fractionAccumulator + elapsedSeconds * microsFraction;
+  // The fractions may make the last second end after micros(): it is then
+  // not elapsed yet, and lastMicros must not pass micros()
+  if (ticks + (accumulator >> 16) > elapsed) {
+    elapsedSeconds--;
+    ticks -= microsPerSecond;
+    accumulator -= microsFraction;
+  }
+  ticks += accumulator >> 16;
+  fractionAccumulator = accumulator;
+  lastMicros += ticks;
+  lastUnix += elapsedSeconds;
+  return elapsed - ticks;
+}
 
 /**************************************************************************/
 /*!
@@ -26,8 +82,27 @@ void RTC_Micros::adjustDrift(int ppm) { microsPerSecond = 1000000 - ppm; }
 */
 /**************************************************************************/
 DateTime RTC_Micros::now() {
-  uint32_t elapsedSeconds = (micros() - lastMicros) / microsPerSecond;
-  lastMicros += elapsedSeconds * microsPerSecond;
-  lastUnix += elapsedSeconds;
+  advance();
   return lastUnix;
 }
+
+/**************************************************************************/
+/*!
+    @brief  Get the current date/time with a microsecond resolution.
+    @details The fraction of the current second is scaled from `micros()`
+        ticks to calibrated microseconds, within 1&nbsp;µs.
+    @return PreciseDateTime object containing the current date/time
+*/
+/**************************************************************************/
+PreciseDateTime RTC_Micros::nowPrecise() {
+  uint32_t fraction = advance();
+  // fraction * 1e6 / microsPerSecond, without 64-bit arithmetic
+  int32_t correction = 1000000L - (int32_t)microsPerSecond;
+  if (correction) {
+    fraction += (int32_t)(fraction >> 5) * correction /
+                (int32_t)(microsPerSecond >> 5);
+  }
+  if (fraction > 999999)
+    fraction = 999999;
+  return PreciseDateTime(lastUnix, fraction);
+}
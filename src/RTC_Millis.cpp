@@ -11,6 +11,18 @@ void RTC_Millis::adjust(const DateTime &dt) {
   lastUnix = dt.unixtime();
 }
 
+/**************************************************************************/
+/*!
+    @brief  Set the current date/time of the RTC_Millis clock, including
+            the fraction of a second.
+    @param dt PreciseDateTime object with the desired date and time
+*/
+/**************************************************************************/
+void RTC_Millis::adjust(const PreciseDateTime &dt) {
+  lastMillis = millis() - dt.millisecond();
+  lastUnix = dt.unixtime();
+}
+
 /**************************************************************************/
 /*!
     @brief  Return a DateTime object containing the current date/time.
@@ -25,3 +37,18 @@ DateTime RTC_Millis::now() {
   lastUnix += elapsedSeconds;
   return lastUnix;
 }
+
+/**************************************************************************/
+/*!
+    @brief  Return the current date/time with a millisecond resolution.
+            The same rollover constraint as now() applies.
+    @return PreciseDateTime object containing current time
+*/
+/**************************************************************************/
+PreciseDateTime RTC_Millis::nowPrecise() {
+  uint32_t elapsed = millis() - lastMillis;
+  uint32_t elapsedSeconds = elapsed / 1000;
+  lastMillis += elapsedSeconds * 1000;
+  lastUnix += elapsedSeconds;
+  return PreciseDateTime(lastUnix, (elapsed - elapsedSeconds * 1000) * 1000);
+}
@@ -18,12 +18,7 @@
 */
 /**************************************************************************/
 bool RTC_PCF8523::begin(TwoWire *wireInstance) {
-  if (i2c_dev)
-    delete i2c_dev;
-  i2c_dev = new Adafruit_I2CDevice(PCF8523_ADDRESS, wireInstance);
-  if (!i2c_dev->begin())
-    return false;
-  return true;
+  return beginDevice(PCF8523_ADDRESS, wireInstance);
 }
 
 /**************************************************************************/
@@ -59,14 +54,8 @@ bool RTC_PCF8523::initialized(void) {
 */
 /**************************************************************************/
 void RTC_PCF8523::adjust(const DateTime &dt) {
-  uint8_t buffer[8] = {3, // start at location 3
-                       bin2bcd(dt.second()),
-                       bin2bcd(dt.minute()),
-                       bin2bcd(dt.hour()),
-                       bin2bcd(dt.day()),
-                       bin2bcd(0), // skip weekdays
-                       bin2bcd(dt.month()),
-                       bin2bcd(dt.year() - 2000U)};
+  uint8_t buffer[8] = {PCF8523_STATUSREG}; // start at location 3
+  encodeTime(dt, buffer + 1);
   i2c_dev->write(buffer, 8);
 
   // set to battery switchover mode
@@ -81,12 +70,97 @@ void RTC_PCF8523::adjust(const DateTime &dt) {
 /**************************************************************************/
 DateTime RTC_PCF8523::now() {
   uint8_t buffer[7];
-  buffer[0] = 3;
+  buffer[0] = PCF8523_STATUSREG;
   i2c_dev->write_then_read(buffer, 1, buffer, 7);
 
-  return DateTime(bcd2bin(buffer[6]) + 2000U, bcd2bin(buffer[5]),
-                  bcd2bin(buffer[3]), bcd2bin(buffer[2]), bcd2bin(buffer[1]),
-                  bcd2bin(buffer[0] & 0x7F));
+  return decodeTime(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start reading the date/time without blocking.
+    @details The reading is carried out by calling pollNow() until it
+    returns true. The PCF8523 must not be accessed otherwise in the meantime.
+*/
+/**************************************************************************/
+void RTC_PCF8523::requestNow(void) { startRead(PCF8523_STATUSREG, 7); }
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a reading started by requestNow().
+    @details Each call does at most one short I2C transaction.
+    @param[out] dt Receives the date/time once the reading completes
+    @return True if the reading completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_PCF8523::pollNow(DateTime &dt) {
+  if (!stepTransfer())
+    return false;
+  dt = decodeTime(transferBuffer);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start setting the date/time without blocking.
+    @details The setting is carried out by calling pollAdjust() until it
+    returns true. The PCF8523 must not be accessed otherwise in the meantime.
+    @param dt DateTime to set
+*/
+/**************************************************************************/
+void RTC_PCF8523::requestAdjust(const DateTime &dt) {
+  uint8_t buffer[7];
+  encodeTime(dt, buffer);
+  startWrite(PCF8523_STATUSREG, buffer, 7);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a setting started by requestAdjust().
+    @details Writes all the time registers in a single I2C transaction, then
+    sets the battery switchover mode. Written in pieces, the time registers
+    could tear if the seconds rolled over in between.
+    @return True if the setting completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_PCF8523::pollAdjust(void) {
+  if (!stepTransfer())
+    return false;
+  // set to battery switchover mode
+  write_register(PCF8523_CONTROL_3, 0x00);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the date/time registers
+    @param regs Contents of the registers, starting at PCF8523_STATUSREG
+    @return DateTime object containing the date/time
+*/
+/**************************************************************************/
+DateTime RTC_PCF8523::decodeTime(const uint8_t *regs) {
+  return DateTime(bcd2bin(regs[6]) + 2000U, bcd2bin(regs[5]), bcd2bin(regs[3]),
+                  bcd2bin(regs[2]), bcd2bin(regs[1]), bcd2bin(regs[0] & 0x7F));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encode a date/time into the date/time registers
+    @param dt DateTime to encode
+    @param[out] regs Receives the contents of the registers, starting at
+        PCF8523_STATUSREG
+*/
+/**************************************************************************/
+void RTC_PCF8523::encodeTime(const DateTime &dt, uint8_t *regs) {
+  regs[0] = bin2bcd(dt.second());
+  regs[1] = bin2bcd(dt.minute());
+  regs[2] = bin2bcd(dt.hour());
+  regs[3] = bin2bcd(dt.day());
+  regs[4] = 0; // skip weekdays
+  regs[5] = bin2bcd(dt.month());
+  regs[6] = bin2bcd(dt.year() - 2000U);
 }
 
 /**************************************************************************/
@@ -290,3 +364,68 @@ void RTC_PCF8523::deconfigureAllTimers() {
 void RTC_PCF8523::calibrate(Pcf8523OffsetMode mode, int8_t offset) {
   write_register(PCF8523_OFFSET, ((uint8_t)offset & 0x7F) | mode);
 }
+
+/**************************************************************************/
+/*!
+    @brief  Create a calibration, assuming the RTC is not calibrated.
+*/
+/**************************************************************************/
+Pcf8523Calibration::Pcf8523Calibration() : residualPpm(0) { begin(); }
+
+/**************************************************************************/
+/*!
+    @brief  Start a new measurement.
+    @param mode Offset mode currently programmed in the RTC
+    @param offset Offset value currently programmed in the RTC
+*/
+/**************************************************************************/
+void Pcf8523Calibration::begin(Pcf8523OffsetMode mode, int8_t offset) {
+  reset();
+  offsetMode = mode;
+  offsetValue = offset;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Compute and apply the calibration cancelling the measured drift,
+            then start a new measurement.
+
+    Both offset modes are considered, and the one leaving the smallest
+    residual drift is used. `PCF8523_TwoHours`, which draws less power, is
+    preferred when they are equally good.
+
+    @param rtc The RTC to calibrate
+    @return False if fewer than two samples spanning some time were added.
+*/
+/**************************************************************************/
+bool Pcf8523Calibration::apply(RTC_PCF8523 &rtc) {
+  if (count < 2 || sumXX <= 0)
+    return false;
+  // Correction in effect, in ppm (a positive offset slows the RTC down)
+  static const float ppmPerStep[2] = {4.34f, 4.069f};
+  float target = offsetValue * ppmPerStep[offsetMode == PCF8523_OneMinute] +
+                 drift();
+
+  Pcf8523OffsetMode bestMode = PCF8523_TwoHours;
+  int8_t bestOffset = 0;
+  float bestResidual = 0, bestMagnitude = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    float steps = target / ppmPerStep[i];
+    int8_t value = steps >= 63    ? 63
+                   : steps <= -64 ? -64
+                   : steps < 0    ? (int8_t)(steps - 0.5f)
+                                  : (int8_t)(steps + 0.5f);
+    float residual = target - value * ppmPerStep[i];
+    float magnitude = residual < 0 ? -residual : residual;
+    if (i == 0 || magnitude + 0.01f < bestMagnitude) {
+      bestMode = i ? PCF8523_OneMinute : PCF8523_TwoHours;
+      bestOffset = value;
+      bestResidual = residual;
+      bestMagnitude = magnitude;
+    }
+  }
+  rtc.calibrate(bestMode, bestOffset);
+  residualPpm = bestResidual;
+  begin(bestMode, bestOffset);
+  return true;
+}
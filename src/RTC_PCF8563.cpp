@@ -15,12 +15,7 @@
 */
 /**************************************************************************/
 bool RTC_PCF8563::begin(TwoWire *wireInstance) {
-  if (i2c_dev)
-    delete i2c_dev;
-  i2c_dev = new Adafruit_I2CDevice(PCF8563_ADDRESS, wireInstance);
-  if (!i2c_dev->begin())
-    return false;
-  return true;
+  return beginDevice(PCF8563_ADDRESS, wireInstance);
 }
 
 /**************************************************************************/
@@ -45,11 +40,8 @@ bool RTC_PCF8563::lostPower(void) {
 */
 /**************************************************************************/
 void RTC_PCF8563::adjust(const DateTime &dt) {
-  uint8_t buffer[8] = {PCF8563_VL_SECONDS, // start at location 2, VL_SECONDS
-                       bin2bcd(dt.second()), bin2bcd(dt.minute()),
-                       bin2bcd(dt.hour()),   bin2bcd(dt.day()),
-                       bin2bcd(0), // skip weekdays
-                       bin2bcd(dt.month()),  bin2bcd(dt.year() - 2000U)};
+  uint8_t buffer[8] = {PCF8563_VL_SECONDS}; // start at location 2, VL_SECONDS
+  encodeTime(dt, buffer + 1);
   i2c_dev->write(buffer, 8);
 }
 
@@ -64,9 +56,89 @@ DateTime RTC_PCF8563::now() {
   buffer[0] = PCF8563_VL_SECONDS; // start at location 2, VL_SECONDS
   i2c_dev->write_then_read(buffer, 1, buffer, 7);
 
-  return DateTime(bcd2bin(buffer[6]) + 2000U, bcd2bin(buffer[5] & 0x1F),
-                  bcd2bin(buffer[3] & 0x3F), bcd2bin(buffer[2] & 0x3F),
-                  bcd2bin(buffer[1] & 0x7F), bcd2bin(buffer[0] & 0x7F));
+  return decodeTime(buffer);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start reading the date/time without blocking.
+    @details The reading is carried out by calling pollNow() until it
+    returns true. The PCF8563 must not be accessed otherwise in the meantime.
+*/
+/**************************************************************************/
+void RTC_PCF8563::requestNow(void) { startRead(PCF8563_VL_SECONDS, 7); }
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a reading started by requestNow().
+    @details Each call does at most one short I2C transaction.
+    @param[out] dt Receives the date/time once the reading completes
+    @return True if the reading completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_PCF8563::pollNow(DateTime &dt) {
+  if (!stepTransfer())
+    return false;
+  dt = decodeTime(transferBuffer);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start setting the date/time without blocking.
+    @details The setting is carried out by calling pollAdjust() until it
+    returns true. The PCF8563 must not be accessed otherwise in the meantime.
+    @param dt DateTime to set
+*/
+/**************************************************************************/
+void RTC_PCF8563::requestAdjust(const DateTime &dt) {
+  uint8_t buffer[7];
+  encodeTime(dt, buffer);
+  startWrite(PCF8563_VL_SECONDS, buffer, 7);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Make progress on a setting started by requestAdjust().
+    @details Writes all the time registers in a single I2C transaction:
+    written in pieces, they could tear if the seconds rolled over in
+    between.
+    @return True if the setting completed, false if it is still in progress
+        or if none was requested.
+*/
+/**************************************************************************/
+bool RTC_PCF8563::pollAdjust(void) { return stepTransfer(); }
+
+/**************************************************************************/
+/*!
+    @brief  Decode the date/time registers
+    @param regs Contents of the registers, starting at PCF8563_VL_SECONDS
+    @return DateTime object containing the date/time
+*/
+/**************************************************************************/
+DateTime RTC_PCF8563::decodeTime(const uint8_t *regs) {
+  return DateTime(bcd2bin(regs[6]) + 2000U, bcd2bin(regs[5] & 0x1F),
+                  bcd2bin(regs[3] & 0x3F), bcd2bin(regs[2] & 0x3F),
+                  bcd2bin(regs[1] & 0x7F), bcd2bin(regs[0] & 0x7F));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encode a date/time into the date/time registers
+    @param dt DateTime to encode
+    @param[out] regs Receives the contents of the registers, starting at
+        PCF8563_VL_SECONDS
+*/
+/**************************************************************************/
+void RTC_PCF8563::encodeTime(const DateTime &dt, uint8_t *regs) {
+  regs[0] = bin2bcd(dt.second());
+  regs[1] = bin2bcd(dt.minute());
+  regs[2] = bin2bcd(dt.hour());
+  regs[3] = bin2bcd(dt.day());
+  regs[4] = 0; // skip weekdays
+  regs[5] = bin2bcd(dt.month());
+  regs[6] = bin2bcd(dt.year() - 2000U);
 }
 
 /**************************************************************************/
@@ -0,0 +1,137 @@
+#include "RTClib.h"
+
+/**************************************************************************/
+/*!
+    @brief  Set how far apart members may be and still agree.
+    @details The members are not read at the same instant, so two healthy
+    clocks may differ by one second if one of them ticks between the reads.
+    @param seconds Maximum difference between agreeing members, 1 or more
+*/
+/**************************************************************************/
+void RTC_Redundant::setTolerance(uint8_t seconds) {
+  tolerance = seconds ? seconds : 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the date and time of all the members.
+    @param dt DateTime object containing the desired date/time
+*/
+/**************************************************************************/
+void RTC_Redundant::adjust(const DateTime &dt) {
+  for (uint8_t i = 0; i < count; i++)
+    members[i].adjust(members[i].rtc, dt);
+  lostMask = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Number of members needed for a consensus.
+    @details The members known to have lost power do not vote, until they
+    are set again.
+    @return More than half the number of members that kept their time.
+*/
+/**************************************************************************/
+uint8_t RTC_Redundant::majority() const {
+  uint8_t voters = count;
+  for (uint8_t i = 0; i < count; i++)
+    voters -= (lostMask >> i) & 1;
+  return voters / 2 + 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Find the largest group of readings that agree.
+    @param times Unix times read from the members
+    @param n Number of readings
+    @param[out] center Index of the reading the group is centered on
+    @return Number of readings in the group.
+*/
+/**************************************************************************/
+uint8_t RTC_Redundant::cluster(const uint32_t *times, uint8_t n,
+                               uint8_t &center) const {
+  uint8_t best = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t size = 0;
+    for (uint8_t j = 0; j < n; j++) {
+      uint32_t diff = times[i] > times[j] ? times[i] - times[j]
+                                          : times[j] - times[i];
+      size += diff <= tolerance;
+    }
+    if (size > best) {
+      best = size;
+      center = i;
+    }
+  }
+  return best;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the consensus date and time of the members.
+
+    The members are read in turn, skipping those that lost power, until a
+    majority() of them agree. If they do not, the members that disagree are
+    checked for a power loss since they were added, and those that lost
+    power are left out of the vote. Once a majority agrees, the members
+    that lost power or disagreed are set to the consensus time. Otherwise
+    no member is changed, and the time returned is the median of the
+    largest group of agreeing members, which confidence() reports.
+
+    @return Median time of the agreeing members, or 2000-01-01 if no member
+        could be read.
+*/
+/**************************************************************************/
+DateTime RTC_Redundant::now() {
+  uint32_t times[RTC_REDUNDANT_MAX_MEMBERS];
+  uint8_t index[RTC_REDUNDANT_MAX_MEMBERS];
+  uint8_t n = 0, center = 0;
+  agreeing = 0;
+  faultMask = lostMask;
+  if (!count)
+    return DateTime();
+
+  for (uint8_t k = 0; k < count && agreeing < majority(); k++) {
+    uint8_t i = (first + k) % count;
+    if (lostMask & (1 << i))
+      continue;
+    times[n] = members[i].now(members[i].rtc).unixtime();
+    index[n++] = i;
+    agreeing = cluster(times, n, center);
+  }
+  first = (first + 1) % count;
+  if (!n)
+    return DateTime();
+
+  // Sort the agreeing readings, flag the others
+  uint32_t group[RTC_REDUNDANT_MAX_MEMBERS];
+  uint8_t size = 0;
+  for (uint8_t j = 0; j < n; j++) {
+    uint32_t diff = times[j] > times[center] ? times[j] - times[center]
+                                             : times[center] - times[j];
+    if (diff > tolerance) {
+      faultMask |= 1 << index[j];
+      continue;
+    }
+    uint8_t pos = size++;
+    for (; pos && group[pos - 1] > times[j]; pos--)
+      group[pos] = group[pos - 1];
+    group[pos] = times[j];
+  }
+  DateTime median(group[(size - 1) / 2]);
+
+  // Without a majority, the members that disagree may have lost power
+  if (agreeing < majority()) {
+    for (uint8_t i = 0; i < count; i++)
+      if ((faultMask & ~lostMask & (1 << i)) &&
+          members[i].lostPower(members[i].rtc))
+        lostMask |= 1 << i;
+  }
+  if (agreeing >= majority()) {
+    for (uint8_t i = 0; i < count; i++)
+      if (faultMask & (1 << i))
+        members[i].adjust(members[i].rtc, median);
+    lostMask = 0;
+  }
+  return median;
+}
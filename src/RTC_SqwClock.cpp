@@ -0,0 +1,77 @@
+#include "RTClib.h"
+
+/**************************************************************************/
+/*!
+    @brief  Set the current date/time of the RTC_SqwClock.
+    @param dt DateTime object with the date and time at the last edge
+*/
+/**************************************************************************/
+void RTC_SqwClock::adjust(const DateTime &dt) {
+  uint32_t t = dt.unixtime();
+  noInterrupts();
+  tickUnix = t;
+  if (!ticked)
+    tickMicros = micros(); // no edge yet: count from now
+  interrupts();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Record an edge of the square wave. Call this from the interrupt
+            handler attached to the square wave pin.
+*/
+/**************************************************************************/
+void RTC_SqwClock::tick(void) {
+  tickMicros = micros();
+  tickUnix = tickUnix + 1;
+  ticked = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Wait for the next edge of the square wave.
+    @return False if no edge was seen within 1.1 seconds, true otherwise.
+*/
+/**************************************************************************/
+bool RTC_SqwClock::waitForTick(void) {
+  noInterrupts();
+  uint32_t last = tickMicros;
+  interrupts();
+  uint32_t start = micros();
+  while (micros() - start < 1100000) {
+    noInterrupts();
+    uint32_t edge = tickMicros;
+    interrupts();
+    if (edge != last)
+      return true;
+  }
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the current date/time, truncated to the second.
+    @return DateTime object containing the current date/time
+*/
+/**************************************************************************/
+DateTime RTC_SqwClock::now() { return nowPrecise(); }
+
+/**************************************************************************/
+/*!
+    @brief  Get the current date/time with a microsecond resolution.
+    @details The fraction is the time elapsed since the last edge, or 0
+        until the first edge has been seen.
+    @return PreciseDateTime object containing the current date/time
+*/
+/**************************************************************************/
+PreciseDateTime RTC_SqwClock::nowPrecise() {
+  noInterrupts();
+  uint32_t t = tickUnix;
+  uint32_t edge = tickMicros;
+  bool phaseKnown = ticked;
+  interrupts();
+  // Normally below one second, more if edges were missed
+  uint32_t elapsed = micros() - edge;
+  uint32_t fraction = phaseKnown ? elapsed % 1000000 : 0;
+  return PreciseDateTime(t + elapsed / 1000000, fraction);
+}
@@ -24,15 +24,42 @@
     - DateTime represents a specific point in time; this is the data
       type used for setting and reading the supported RTCs
     - TimeSpan represents the length of a time interval
+    - DateTime64 and TimeSpan64 are their extended-range counterparts,
+      covering years 1--9999
+    - PreciseDateTime and PreciseTimeSpan add a microsecond fraction to
+      DateTime and TimeSpan
+    - TimeZone converts between UTC and local time, following the DST
+      rules of a POSIX `TZ` string
   - Interfacing specific RTC chips:
     - RTC_DS1307
     - RTC_DS3231
     - RTC_PCF8523
     - RTC_PCF8563
+
+    All of them can also be read and set without blocking the sketch for a
+    whole I2C transfer, through requestNow() and pollNow()
+  - RTC_Interface is the statically dispatched interface shared by all the
+    RTC classes, for writing chip-generic code; RTC_Traits describes the
+    capabilities of each class
   - RTC emulated in software; do not expect much accuracy out of these:
     - RTC_Millis is based on `millis()`
     - RTC_Micros is based on `micros()`; its drift rate can be tuned by
       the user
+  - RTC_Cached serves the time of a hardware RTC from `micros()`,
+    reading the chip only once per resync interval
+  - RTC_SqwClock gives sub-second time from the 1&nbsp;Hz square wave of
+    a hardware RTC
+  - RTC_Discipline keeps an RTC_Micros clock in step with a hardware RTC,
+    correcting the drift of `micros()` automatically
+  - DriftMeasurement measures the drift of an RTC against a reference
+    clock; Pcf8523Calibration and Ds3231AgingTrim use it to program the
+    offset of a PCF8523 or the aging offset of a DS3231
+  - AlarmScheduler multiplexes any number of alarms onto one hardware alarm
+    of the DS3231
+  - CronSchedule matches dates against a crontab-style expression and finds
+    the next matching date, e.g. to program an RTC alarm
+  - RTC_Redundant votes between several RTCs, returning the majority time
+    and resetting the members that lost power or drifted away
 
   @section license License
 
@@ -56,6 +83,22 @@
 #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
 #endif
 
+/**************************************************************************/
+/*!
+    @brief  Set up the I2C device of the RTC and test the connection.
+    @details The device lives inside the RTC object, so this never
+    allocates memory, and can be retried after a bus fault.
+    @param addr I2C address of the RTC
+    @param wireInstance pointer to the I2C bus
+    @return True if the RTC answers on the bus, false otherwise.
+*/
+/**************************************************************************/
+bool RTC_I2C::beginDevice(uint8_t addr, TwoWire *wireInstance) {
+  device = Adafruit_I2CDevice(addr, wireInstance);
+  i2c_dev = &device;
+  return i2c_dev->begin();
+}
+
 /**************************************************************************/
 /*!
     @brief Write value to register.
@@ -82,6 +125,104 @@ uint8_t RTC_I2C::read_register(uint8_t reg) {
   return buffer[0];
 }
 
+/** Steps of a split-phase transfer */
+enum {
+  TRANSFER_IDLE,          ///< No transfer in progress
+  TRANSFER_POINTER,       ///< Set the register pointer for reading
+  TRANSFER_READ,          ///< Read the next chunk
+  TRANSFER_CHECK_POINTER, ///< Set the register pointer for the check
+  TRANSFER_CHECK,         ///< Read the first register again
+  TRANSFER_WRITE          ///< Write all the registers
+};
+
+/**************************************************************************/
+/*!
+    @brief  Start a split-phase read of consecutive registers.
+
+    The transfer is then carried out by successive calls to stepTransfer(),
+    each doing a single I2C transaction reading at most
+    `RTC_TRANSFER_CHUNK` bytes. Once all the registers are read, the first
+    one is read again: if it changed, e.g. because the seconds rolled over
+    in the middle of the transfer, the read starts over. Reading the time
+    with this check never returns torn values.
+
+    @param reg First register
+    @param len Number of registers, at most 7
+*/
+/**************************************************************************/
+void RTC_I2C::startRead(uint8_t reg, uint8_t len) {
+  transferReg = reg;
+  transferLen = len;
+  transferState = TRANSFER_POINTER;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start a split-phase write of consecutive registers.
+    @details Unlike a read, the write is done by a single call to
+    stepTransfer(), in a single I2C transaction: written in chunks, the
+    time registers could tear, as the chip would carry the seconds into the
+    registers already written. It is split from the call to startWrite()
+    only for symmetry with reads.
+    @param reg First register
+    @param data Values to write, copied before returning
+    @param len Number of registers, at most 7
+*/
+/**************************************************************************/
+void RTC_I2C::startWrite(uint8_t reg, const uint8_t *data, uint8_t len) {
+  memcpy(transferBuffer, data, len);
+  transferReg = reg;
+  transferLen = len;
+  transferState = TRANSFER_WRITE;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Perform the next step of a split-phase transfer.
+    @details No other access to the same chip should be made until the
+    transfer completes, as it would move the register pointer.
+    @return True if this step completed the transfer, whose data is then in
+        `transferBuffer`. False if the transfer is still in progress, or if
+        there is none.
+*/
+/**************************************************************************/
+bool RTC_I2C::stepTransfer(void) {
+  switch (transferState) {
+  case TRANSFER_POINTER:
+  case TRANSFER_CHECK_POINTER:
+    i2c_dev->write(&transferReg, 1);
+    transferPos = 0;
+    transferState++;
+    return false;
+  case TRANSFER_READ: {
+    uint8_t chunk = transferLen - transferPos;
+    if (chunk > RTC_TRANSFER_CHUNK)
+      chunk = RTC_TRANSFER_CHUNK;
+    i2c_dev->read(transferBuffer + transferPos, chunk);
+    transferPos += chunk;
+    if (transferPos == transferLen)
+      transferState = TRANSFER_CHECK_POINTER;
+    return false;
+  }
+  case TRANSFER_CHECK: {
+    uint8_t first;
+    i2c_dev->read(&first, 1);
+    if (first != transferBuffer[0]) {
+      transferState = TRANSFER_POINTER;
+      return false;
+    }
+    break;
+  }
+  case TRANSFER_WRITE:
+    i2c_dev->write(transferBuffer, transferLen, true, &transferReg, 1);
+    break;
+  default:
+    return false;
+  }
+  transferState = TRANSFER_IDLE;
+  return true;
+}
+
 /**************************************************************************/
 // utility code, some of this could be exposed in the DateTime API if needed
 /**************************************************************************/
@@ -94,6 +235,39 @@ uint8_t RTC_I2C::read_register(uint8_t reg) {
 const uint8_t daysInMonth[] PROGMEM = {31, 28, 31, 30, 31, 30,
                                        31, 31, 30, 31, 30};
 
+/** Two-digit decimal representations of 0--99 */
+static PROGMEM const char two_digits[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536"
+    "37383940414243444546474849505152535455565758596061626364656667686970717273"
+    "7475767778798081828384858687888990919293949596979899";
+
+/**************************************************************************/
+/*!
+    @brief  Write a number as at least two decimal digits, like the
+            `"%02d"` format of `printf()`.
+    @param p Pointer to the output
+    @param v Number to write
+    @return Pointer past the last written character
+*/
+/**************************************************************************/
+static char *write2d(char *p, uint8_t v) {
+  if (v >= 100) {
+    *p++ = '0' + v / 100;
+    v %= 100;
+  }
+  const char *digits = &two_digits[2 * v];
+  *p++ = pgm_read_byte(digits);
+  *p++ = pgm_read_byte(digits + 1);
+  return p;
+}
+
+/** Abbreviated English day names, starting on Sunday */
+static PROGMEM const char day_names[] = "SunMonTueWedThuFriSat";
+
+/** Abbreviated English month names */
+static PROGMEM const char month_names[] =
+    "JanFebMarAprMayJunJulAugSepOctNovDec";
+
 /**************************************************************************/
 /*!
     @brief  Given a date, return number of days since 2000/01/01,
@@ -167,22 +341,19 @@ DateTime::DateTime(uint32_t t) {
   t /= 60;
   hh = t % 24;
   uint16_t days = t / 24;
-  uint8_t leap;
-  for (yOff = 0;; ++yOff) {
-    leap = yOff % 4 == 0;
-    if (days < 365U + leap)
-      break;
-    days -= 365 + leap;
-  }
-  for (m = 1; m < 12; ++m) {
-    uint8_t daysPerMonth = pgm_read_byte(daysInMonth + m - 1);
-    if (leap && m == 2)
-      ++daysPerMonth;
-    if (days < daysPerMonth)
-      break;
-    days -= daysPerMonth;
-  }
-  d = days + 1;
+
+  // Count the days from 1996-03-01, so that each four-year cycle ends with
+  // its leap day and the year can be computed without a loop. Years are
+  // counted from March: Jan and Feb belong to the previous "March year".
+  days += 1401;
+  uint16_t cycle = days / 1461;           // four-year cycles since 1996-03-01
+  uint16_t doc = days - cycle * 1461;     // day of cycle (0--1460)
+  uint8_t yoc = (doc - doc / 1460) / 365; // year of cycle (0--3)
+  uint16_t doy = doc - 365 * yoc;         // day of the March year (0--365)
+  uint8_t mp = (5 * doy + 2) / 153;       // month index from March (0--11)
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  yOff = 4 * cycle + yoc + (m <= 2) - 4;
 }
 
 /**************************************************************************/
@@ -360,6 +531,9 @@ DateTime::DateTime(const __FlashStringHelper *date,
 
     @note The year must be > 2000, as only the yOff is considered.
 
+    @see parseIso8601() validates its input and accepts more forms of ISO
+        8601 timestamps.
+
     @param iso8601dateTime
            A dateTime string in iso8601 format,
            e.g. "2020-06-25T15:29:37".
@@ -377,6 +551,168 @@ DateTime::DateTime(const char *iso8601dateTime) {
   ss = conv2d(ref + 17);
 }
 
+#ifndef RTCLIB_NO_ISO8601
+/**************************************************************************/
+/*!
+    @brief  Parse a fixed number of decimal digits.
+    @param[in,out] p Pointer to the digits, advanced past them on success
+    @param n Number of digits
+    @param[out] value Parsed value
+    @return True if there were n digits, false otherwise.
+*/
+/**************************************************************************/
+static bool parseDigits(const char *&p, uint8_t n, uint16_t &value) {
+  value = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t digit = p[i] - '0';
+    if (digit > 9)
+      return false;
+    value = 10 * value + digit;
+  }
+  p += n;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Parse and validate an ISO 8601 timestamp.
+
+    The following forms are accepted, where `±hh:mm` is an optional UTC
+    offset that may also be written `±hhmm`, `±hh` or `Z`:
+
+    - `YYYY-MM-DD`
+    - `YYYY-MM-DDThh:mm±hh:mm`
+    - `YYYY-MM-DDThh:mm:ss±hh:mm`
+    - `YYYY-MM-DDThh:mm:ss.ffffff±hh:mm`, with any number of fractional
+      digits, separated by either `.` or `,`
+
+    The `T` separator can also be a space. Parsing stops at the end of the
+    timestamp: the characters following it are not checked, and the number
+    of characters consumed is returned.
+
+    @param str String starting with the timestamp
+    @return Iso8601Result with the status of the parsing, the number of
+        characters consumed and the parsed fields.
+*/
+/**************************************************************************/
+Iso8601Result parseIso8601(const char *str) {
+  Iso8601Result result;
+  result.status = ISO8601_SYNTAX;
+  result.length = 0;
+  result.fraction = 0;
+  result.offset = TIMESTAMP_NO_OFFSET;
+  const char *p = str;
+  uint16_t year, month, day, hour = 0, minute = 0, second = 0;
+
+  if (!parseDigits(p, 4, year) || *p++ != '-' || !parseDigits(p, 2, month) ||
+      *p++ != '-' || !parseDigits(p, 2, day))
+    return result;
+  if (*p == 'T' || (*p == ' ' && '0' <= p[1] && p[1] <= '9')) {
+    p++;
+    if (!parseDigits(p, 2, hour) || *p++ != ':' || !parseDigits(p, 2, minute))
+      return result;
+    if (*p == ':') {
+      p++;
+      if (!parseDigits(p, 2, second))
+        return result;
+      if (*p == '.' || *p == ',') {
+        p++;
+        if (*p < '0' || *p > '9')
+          return result;
+        uint32_t scale = 100000;
+        for (; '0' <= *p && *p <= '9'; p++) {
+          result.fraction += (*p - '0') * scale;
+          scale /= 10;
+        }
+      }
+    }
+    if (*p == 'Z') {
+      p++;
+      result.offset = 0;
+    } else if (*p == '+' || *p == '-') {
+      bool negative = *p++ == '-';
+      uint16_t offsetHours, offsetMinutes = 0;
+      if (!parseDigits(p, 2, offsetHours))
+        return result;
+      // The minutes are optional, but a colon must be followed by them
+      bool colon = *p == ':';
+      if (colon)
+        p++;
+      if ((colon || ('0' <= *p && *p <= '9')) &&
+          !parseDigits(p, 2, offsetMinutes))
+        return result;
+      if (offsetHours > 23 || offsetMinutes > 59) {
+        result.status = ISO8601_RANGE;
+        return result;
+      }
+      result.offset = offsetHours * 60 + offsetMinutes;
+      if (negative)
+        result.offset = -result.offset;
+    }
+  }
+  result.length = p - str;
+
+  uint8_t monthDays = 0;
+  if (1 <= month && month <= 12)
+    monthDays = month == 12 ? 31 : pgm_read_byte(daysInMonth + month - 1);
+  if (month == 2 && year % 4 == 0)
+    monthDays++;
+  if (year < 2000 || year > 2099 || day < 1 || day > monthDays || hour > 23 ||
+      minute > 59 || second > 59) {
+    result.status = ISO8601_RANGE;
+    return result;
+  }
+  result.time = DateTime(year, month, day, hour, minute, second);
+  result.status = ISO8601_OK;
+  return result;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Parse a list of ISO 8601 timestamps, one per line, into Unix
+            times.
+
+    Each line should hold a single timestamp, in any of the forms accepted
+    by parseIso8601(). Lines can end with either `\n` or `\r\n`; empty lines
+    are skipped. Timestamps with a UTC offset are converted to UTC.
+    Fractions of a second are dropped.
+
+    @param text Null-terminated list of timestamps
+    @param[out] times Array receiving the Unix times
+    @param maxCount Number of elements in `times`
+    @param[out] end Optional. Receives a pointer to the first line that
+        could not be parsed, or to the remaining text if `times` is full, or
+        to the terminating null character if all the text was parsed.
+    @return Number of timestamps stored in `times`.
+*/
+/**************************************************************************/
+size_t parseIso8601Lines(const char *text, uint32_t *times, size_t maxCount,
+                         const char **end) {
+  size_t count = 0;
+  const char *p = text;
+  while (count < maxCount) {
+    while (*p == '\n' || *p == '\r')
+      p++;
+    if (!*p)
+      break;
+    Iso8601Result result = parseIso8601(p);
+    const char *next = p + result.length;
+    if (*next == '\r')
+      next++;
+    if (result.status != ISO8601_OK || (*next != '\n' && *next != '\0'))
+      break;
+    uint32_t t = result.time.unixtime();
+    if (result.offset != TIMESTAMP_NO_OFFSET)
+      t -= result.offset * 60L;
+    times[count++] = t;
+    p = next;
+  }
+  if (end)
+    *end = p;
+  return count;
+}
+#endif // RTCLIB_NO_ISO8601
+
 /**************************************************************************/
 /*!
     @brief  Check whether this DateTime is valid.
@@ -415,6 +751,8 @@ bool DateTime::isValid() const {
 
     If either "AP" or "ap" is used, the "hh" specifier uses 12-hour mode
     (range: 01--12). Otherwise it works in 24-hour mode (range: 00--23).
+    12-hour mode is not available if the library is built with
+    `RTCLIB_NO_12H`.
 
     The specifiers within _buffer_ will be overwritten with the appropriate
     values from the DateTime. Any characters not belonging to one of the
@@ -439,8 +777,12 @@ bool DateTime::isValid() const {
 /**************************************************************************/
 
 char *DateTime::toString(char *buffer) const {
+#ifndef RTCLIB_NO_12H
   uint8_t apTag =
       (strstr(buffer, "ap") != nullptr) || (strstr(buffer, "AP") != nullptr);
+#else
+  const uint8_t apTag = false; // "AP" and "ap" are left as is
+#endif
   uint8_t hourReformatted = 0, isPM = false;
   if (apTag) {     // 12 Hour Mode
     if (hh == 0) { // midnight
@@ -477,7 +819,6 @@ char *DateTime::toString(char *buffer) const {
       buffer[i + 1] = '0' + ss % 10;
     }
     if (buffer[i] == 'D' && buffer[i + 1] == 'D' && buffer[i + 2] == 'D') {
-      static PROGMEM const char day_names[] = "SunMonTueWedThuFriSat";
       const char *p = &day_names[3 * dayOfTheWeek()];
       buffer[i] = pgm_read_byte(p);
       buffer[i + 1] = pgm_read_byte(p + 1);
@@ -487,8 +828,6 @@ char *DateTime::toString(char *buffer) const {
       buffer[i + 1] = '0' + d % 10;
     }
     if (buffer[i] == 'M' && buffer[i + 1] == 'M' && buffer[i + 2] == 'M') {
-      static PROGMEM const char month_names[] =
-          "JanFebMarAprMayJunJulAugSepOctNovDec";
       const char *p = &month_names[3 * (m - 1)];
       buffer[i] = pgm_read_byte(p);
       buffer[i + 1] = pgm_read_byte(p + 1);
@@ -507,6 +846,8 @@ char *DateTime::toString(char *buffer) const {
       buffer[i] = '0' + (yOff / 10) % 10;
       buffer[i + 1] = '0' + yOff % 10;
     }
+    if (!apTag)
+      continue;
     if (buffer[i] == 'A' && buffer[i + 1] == 'P') {
       if (isPM) {
         buffer[i] = 'P';
@@ -528,6 +869,162 @@ char *DateTime::toString(char *buffer) const {
   return buffer;
 }
 
+/** Operations of a DateTimeFormat, other than literal characters */
+enum {
+  FMT_LITERAL = 0x80, // the next operation is a literal character >= 0x80
+  FMT_YYYY,
+  FMT_YY,
+  FMT_MMM,
+  FMT_MM,
+  FMT_DDD,
+  FMT_DD,
+  FMT_hh,
+  FMT_mm,
+  FMT_ss,
+  FMT_AP,
+  FMT_ap
+};
+
+/**************************************************************************/
+/*!
+    @brief  Compile a format string.
+    @param format Format string, with the specifiers described in
+        DateTime::toString()
+*/
+/**************************************************************************/
+DateTimeFormat::DateTimeFormat(const char *format)
+    : nops(0), len(0), needsDayOfWeek(false) {
+#ifndef RTCLIB_NO_12H
+  twelveHour =
+      (strstr(format, "ap") != nullptr) || (strstr(format, "AP") != nullptr);
+#else
+  twelveHour = false;
+#endif
+  for (const char *p = format; *p && nops < DATETIMEFORMAT_MAX_OPS;) {
+    uint8_t op = 0, width = 2;
+    if (p[0] == 'Y' && p[1] == 'Y' && p[2] == 'Y' && p[3] == 'Y') {
+      op = FMT_YYYY;
+      width = 4;
+    } else if (p[0] == 'Y' && p[1] == 'Y') {
+      op = FMT_YY;
+    } else if (p[0] == 'M' && p[1] == 'M' && p[2] == 'M') {
+      op = FMT_MMM;
+      width = 3;
+    } else if (p[0] == 'M' && p[1] == 'M') {
+      op = FMT_MM;
+    } else if (p[0] == 'D' && p[1] == 'D' && p[2] == 'D') {
+      op = FMT_DDD;
+      width = 3;
+      needsDayOfWeek = true;
+    } else if (p[0] == 'D' && p[1] == 'D') {
+      op = FMT_DD;
+    } else if (p[0] == 'h' && p[1] == 'h') {
+      op = FMT_hh;
+    } else if (p[0] == 'm' && p[1] == 'm') {
+      op = FMT_mm;
+    } else if (p[0] == 's' && p[1] == 's') {
+      op = FMT_ss;
+#ifndef RTCLIB_NO_12H
+    } else if (p[0] == 'A' && p[1] == 'P') {
+      op = FMT_AP;
+    } else if (p[0] == 'a' && p[1] == 'p') {
+      op = FMT_ap;
+#endif
+    }
+    if (op) {
+      ops[nops++] = op;
+      p += width;
+      len += width;
+    } else {
+      if ((uint8_t)*p >= FMT_LITERAL) {
+        if (nops + 1 >= DATETIMEFORMAT_MAX_OPS)
+          break;
+        ops[nops++] = FMT_LITERAL;
+      }
+      ops[nops++] = *p++;
+      len++;
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Write a DateTime using this format.
+    @param dt DateTime to format
+    @param[out] buffer Array of `char` receiving the formatted DateTime. It
+        should have room for at least `length() + 1` characters.
+    @return A pointer to the provided buffer.
+*/
+/**************************************************************************/
+char *DateTimeFormat::format(const DateTime &dt, char *buffer) const {
+  uint8_t hh = twelveHour ? dt.twelveHour() : dt.hour();
+  uint8_t dow = needsDayOfWeek ? dt.dayOfTheWeek() : 0;
+  uint8_t yOff = dt.year() - 2000U;
+  char *out = buffer;
+  const char *name;
+  for (uint8_t i = 0; i < nops; i++) {
+    uint8_t op = ops[i];
+    uint8_t value;
+    switch (op) {
+    case FMT_LITERAL:
+      *out++ = ops[++i];
+      continue;
+    case FMT_YYYY:
+      *out++ = '2';
+      *out++ = '0';
+      value = yOff;
+      break;
+    case FMT_YY:
+      value = yOff;
+      break;
+    case FMT_MMM:
+      name = &month_names[3 * (dt.month() - 1)];
+      *out++ = pgm_read_byte(name);
+      *out++ = pgm_read_byte(name + 1);
+      *out++ = pgm_read_byte(name + 2);
+      continue;
+    case FMT_MM:
+      value = dt.month();
+      break;
+    case FMT_DDD:
+      name = &day_names[3 * dow];
+      *out++ = pgm_read_byte(name);
+      *out++ = pgm_read_byte(name + 1);
+      *out++ = pgm_read_byte(name + 2);
+      continue;
+    case FMT_DD:
+      value = dt.day();
+      break;
+    case FMT_hh:
+      value = hh;
+      break;
+    case FMT_mm:
+      value = dt.minute();
+      break;
+    case FMT_ss:
+      value = dt.second();
+      break;
+#ifndef RTCLIB_NO_12H
+    case FMT_AP:
+      *out++ = dt.isPM() ? 'P' : 'A';
+      *out++ = 'M';
+      continue;
+    case FMT_ap:
+      *out++ = dt.isPM() ? 'p' : 'a';
+      *out++ = 'm';
+      continue;
+#endif
+    default:
+      *out++ = op;
+      continue;
+    }
+    *out++ = '0' + (value / 10) % 10;
+    *out++ = '0' + value % 10;
+  }
+  *out = '\0';
+  return buffer;
+}
+
 /**************************************************************************/
 /*!
       @brief  Return the hour in 12-hour format.
@@ -674,6 +1171,7 @@ bool DateTime::operator==(const DateTime &right) const {
           right.second() == ss);
 }
 
+#ifndef RTCLIB_NO_STRING
 /**************************************************************************/
 /*!
     @brief  Return a ISO 8601 timestamp as a `String` object.
@@ -690,24 +1188,178 @@ bool DateTime::operator==(const DateTime &right) const {
 */
 /**************************************************************************/
 String DateTime::timestamp(timestampOpt opt) const {
-  char buffer[25]; // large enough for any DateTime, including invalid ones
+  char buffer[TIMESTAMP_BUFFER_SIZE];
+  timestamp(buffer, opt);
+  return String(buffer);
+}
+#endif // RTCLIB_NO_STRING
 
-  // Generate timestamp according to opt
-  switch (opt) {
-  case TIMESTAMP_TIME:
-    // Only time
-    sprintf(buffer, "%02d:%02d:%02d", hh, mm, ss);
-    break;
-  case TIMESTAMP_DATE:
-    // Only date
-    sprintf(buffer, "%u-%02d-%02d", 2000U + yOff, m, d);
-    break;
-  default:
-    // Full
-    sprintf(buffer, "%u-%02d-%02dT%02d:%02d:%02d", 2000U + yOff, m, d, hh, mm,
-            ss);
+/**************************************************************************/
+/*!
+    @brief  Write the UTC offset suffix of a timestamp.
+    @param p Where to write the suffix, with room for 6 characters
+    @param offset UTC offset in minutes, or `TIMESTAMP_NO_OFFSET`. Offsets
+        beyond &plusmn;23:59 are clamped, so that the hours fit in two
+        digits.
+    @return Pointer past the last written character
+*/
+/**************************************************************************/
+static char *writeOffset(char *p, int16_t offset) {
+  if (offset == 0) {
+    *p++ = 'Z';
+  } else if (offset != TIMESTAMP_NO_OFFSET) {
+    *p++ = offset < 0 ? '-' : '+';
+    uint16_t minutes = offset < 0 ? -offset : offset;
+    if (minutes > 23 * 60 + 59)
+      minutes = 23 * 60 + 59;
+    p = write2d(p, minutes / 60);
+    *p++ = ':';
+    p = write2d(p, minutes % 60);
   }
-  return String(buffer);
+  return p;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Write a ISO 8601 timestamp to a buffer.
+
+    This generates the same timestamps as the `String` version of
+    `timestamp()`, without allocating memory and without `sprintf()`.
+    Optionally, a UTC offset can be appended to the time, as either `Z` (for
+    an offset of zero) or `+hh:mm`/`-hh:mm`.
+
+    @param[out] buffer Array of `char` receiving the null-terminated
+        timestamp. It should have room for `TIMESTAMP_BUFFER_SIZE`
+        characters.
+    @param opt Format of the timestamp
+    @param offset UTC offset in minutes, within &plusmn;23:59, or
+        `TIMESTAMP_NO_OFFSET` for no suffix. Ignored with `TIMESTAMP_DATE`.
+    @return Length of the timestamp, e.g. 19 for "2020-04-16T18:34:56".
+*/
+/**************************************************************************/
+size_t DateTime::timestamp(char *buffer, timestampOpt opt,
+                           int16_t offset) const {
+  char *p = buffer;
+  if (opt != TIMESTAMP_TIME) {
+    uint16_t y = 2000U + yOff;
+    p = write2d(p, y / 100);
+    p = write2d(p, y % 100);
+    *p++ = '-';
+    p = write2d(p, m);
+    *p++ = '-';
+    p = write2d(p, d);
+  }
+  if (opt == TIMESTAMP_FULL)
+    *p++ = 'T';
+  if (opt != TIMESTAMP_DATE) {
+    p = write2d(p, hh);
+    *p++ = ':';
+    p = write2d(p, mm);
+    *p++ = ':';
+    p = write2d(p, ss);
+    p = writeOffset(p, offset);
+  }
+  *p = '\0';
+  return p - buffer;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Print a ISO 8601 timestamp.
+
+    @see The `char *` version of `timestamp()` for details.
+
+    @param out Where to print the timestamp, e.g. `Serial`
+    @param opt Format of the timestamp
+    @param offset UTC offset in minutes, or `TIMESTAMP_NO_OFFSET`
+    @return Number of characters printed.
+*/
+/**************************************************************************/
+size_t DateTime::timestamp(Print &out, timestampOpt opt,
+                           int16_t offset) const {
+  char buffer[TIMESTAMP_BUFFER_SIZE];
+  size_t len = timestamp(buffer, opt, offset);
+  return out.write((const uint8_t *)buffer, len);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Write a timestamp, without separator nor terminating null
+            character.
+    @param t Unix time to format
+    @param[out] buffer Array of `char` receiving the 19-character timestamp
+    @return Pointer past the last written character
+*/
+/**************************************************************************/
+char *TimestampFormatter::format(uint32_t t, char *buffer) {
+  uint32_t secs = t - dayStart;
+  if (dayStart == 0 || secs >= SECONDS_PER_DAY) {
+    secs = t % SECONDS_PER_DAY;
+    dayStart = t - secs;
+    DateTime(t).timestamp(date, DateTime::TIMESTAMP_DATE);
+    date[10] = 'T';
+  }
+  memcpy(buffer, date, sizeof date);
+  char *p = buffer + sizeof date;
+  uint16_t minutes = secs / 60; // minute of the day
+  p = write2d(p, minutes / 60);
+  *p++ = ':';
+  p = write2d(p, minutes % 60);
+  *p++ = ':';
+  return write2d(p, secs - minutes * 60UL);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Write a batch of timestamps into a buffer.
+    @param times Array of Unix times
+    @param count Number of elements in `times`
+    @param[out] buffer Array of `char` receiving the records. It should have
+        room for `count * TIMESTAMP_RECORD_SIZE` characters. No terminating
+        null character is written.
+    @param separator Character written after each timestamp
+    @return Number of characters written.
+*/
+/**************************************************************************/
+size_t TimestampFormatter::format(const uint32_t *times, size_t count,
+                                  char *buffer, char separator) {
+  char *p = buffer;
+  for (size_t i = 0; i < count; i++) {
+    p = format(times[i], p);
+    *p++ = separator;
+  }
+  return p - buffer;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Pack a DateTime.
+    @param dt DateTime to pack. Its year should be within 2000--2132.
+*/
+/**************************************************************************/
+PackedDateTime::PackedDateTime(const DateTime &dt) {
+  uint16_t date = ((dt.year() - 2000U) * 12U + dt.month() - 1) * 31U +
+                  dt.day() - 1; // fits, as yOff <= 132
+  value = time2ulong(date, dt.hour(), dt.minute(), dt.second());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Unpack to a DateTime.
+    @return DateTime with the packed fields.
+*/
+/**************************************************************************/
+DateTime PackedDateTime::toDateTime() const {
+  uint32_t t = value;
+  uint8_t ss = t % 60;
+  t /= 60;
+  uint8_t mm = t % 60;
+  t /= 60;
+  uint8_t hh = t % 24;
+  uint16_t date = t / 24;
+  uint8_t d = date % 31 + 1;
+  date /= 31;
+  return DateTime(date / 12, date % 12 + 1, d, hh, mm, ss);
 }
 
 /**************************************************************************/
@@ -762,3 +1414,193 @@ TimeSpan TimeSpan::operator+(const TimeSpan &right) const {
 TimeSpan TimeSpan::operator-(const TimeSpan &right) const {
   return TimeSpan(_seconds - right._seconds);
 }
+
+/**************************************************************************/
+/*!
+    @brief  Create a PreciseTimeSpan from seconds and microseconds.
+    @param seconds Number of seconds
+    @param micros Number of microseconds, added to `seconds`. It can be
+        negative or exceed one second.
+*/
+/**************************************************************************/
+PreciseTimeSpan::PreciseTimeSpan(int32_t seconds, int32_t micros)
+    : TimeSpan(seconds + micros / 1000000) {
+  micros %= 1000000;
+  if (micros < 0) {
+    micros += 1000000;
+    _seconds--;
+  }
+  _micros = micros;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Constructor from a DateTime and a fraction of a second.
+    @param dt Date and time
+    @param micros Microseconds after `dt`. Values of one second or more
+        carry over into `dt`.
+*/
+/**************************************************************************/
+PreciseDateTime::PreciseDateTime(const DateTime &dt, uint32_t micros)
+    : DateTime(micros < 1000000 ? dt : dt + TimeSpan(micros / 1000000)),
+      _micros(micros % 1000000) {}
+
+/**************************************************************************/
+/*!
+    @brief  Write a ISO 8601 timestamp with a fraction of a second, e.g.
+            "2020-04-16T18:34:56.789".
+    @param[out] buffer Array of `char` receiving the null-terminated
+        timestamp. It should have room for `TIMESTAMP_BUFFER_SIZE`
+        characters.
+    @param digits Number of fractional digits (0--6), truncated rather
+        than rounded. With 0, no decimal point is written.
+    @param offset UTC offset in minutes, within &plusmn;23:59, or
+        `TIMESTAMP_NO_OFFSET` for no suffix.
+    @return Length of the timestamp.
+*/
+/**************************************************************************/
+size_t PreciseDateTime::preciseTimestamp(char *buffer, uint8_t digits,
+                                         int16_t offset) const {
+  char *p = buffer + timestamp(buffer, TIMESTAMP_FULL, TIMESTAMP_NO_OFFSET);
+  if (digits > 6)
+    digits = 6;
+  if (digits) {
+    *p++ = '.';
+    uint32_t scale = 100000;
+    for (uint8_t i = 0; i < digits; i++) {
+      *p++ = '0' + _micros / scale % 10;
+      scale /= 10;
+    }
+  }
+  p = writeOffset(p, offset);
+  *p = '\0';
+  return p - buffer;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Print a ISO 8601 timestamp with a fraction of a second.
+
+    @see The `char *` version of `preciseTimestamp()` for details.
+
+    @param out Where to print the timestamp, e.g. `Serial`
+    @param digits Number of fractional digits (0--6)
+    @param offset UTC offset in minutes, or `TIMESTAMP_NO_OFFSET`
+    @return Number of characters printed.
+*/
+/**************************************************************************/
+size_t PreciseDateTime::preciseTimestamp(Print &out, uint8_t digits,
+                                         int16_t offset) const {
+  char buffer[TIMESTAMP_BUFFER_SIZE];
+  size_t len = preciseTimestamp(buffer, digits, offset);
+  return out.write((const uint8_t *)buffer, len);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Add a PreciseTimeSpan to the PreciseDateTime object
+    @param span PreciseTimeSpan object
+    @return New PreciseDateTime object with span added to it.
+*/
+/**************************************************************************/
+PreciseDateTime PreciseDateTime::operator+(const PreciseTimeSpan &span) const {
+  return PreciseDateTime(DateTime::operator+(span),
+                         _micros + span.microseconds());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Subtract a PreciseTimeSpan from the PreciseDateTime object
+    @param span PreciseTimeSpan object
+    @return New PreciseDateTime object with span subtracted from it.
+*/
+/**************************************************************************/
+PreciseDateTime PreciseDateTime::operator-(const PreciseTimeSpan &span) const {
+  if (_micros >= span.microseconds())
+    return PreciseDateTime(DateTime::operator-(span),
+                           _micros - span.microseconds());
+  return PreciseDateTime(DateTime::operator-(span + PreciseTimeSpan(1)),
+                         _micros + 1000000 - span.microseconds());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Subtract one PreciseDateTime from another
+    @param right The PreciseDateTime object to subtract from self
+    @return PreciseTimeSpan of the difference, negative if `right` is later.
+*/
+/**************************************************************************/
+PreciseTimeSpan
+PreciseDateTime::operator-(const PreciseDateTime &right) const {
+  return PreciseTimeSpan(DateTime::operator-(right).totalseconds(),
+                         (int32_t)_micros - (int32_t)right._micros);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Test if one PreciseDateTime is less (earlier) than another.
+    @param right Comparison PreciseDateTime object
+    @return True if the left PreciseDateTime is earlier than the right one.
+*/
+/**************************************************************************/
+bool PreciseDateTime::operator<(const PreciseDateTime &right) const {
+  if (DateTime::operator==(right))
+    return _micros < right._micros;
+  return DateTime::operator<(right);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Create an empty drift measurement.
+*/
+/**************************************************************************/
+DriftMeasurement::DriftMeasurement() { reset(); }
+
+/**************************************************************************/
+/*!
+    @brief  Discard all samples and start a new measurement.
+*/
+/**************************************************************************/
+void DriftMeasurement::reset() {
+  origin = last = 0;
+  count = 0;
+  meanX = meanY = sumXX = sumXY = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Add a measurement of the RTC against a reference clock.
+    @details Samples are best taken right after the RTC ticks, as it only
+    reports whole seconds. Spacing them over several days makes the
+    measurement insensitive to that rounding.
+    @param reference Time given by the reference clock
+    @param rtcTime Time read from the RTC at the same moment
+*/
+/**************************************************************************/
+void DriftMeasurement::addSample(const PreciseDateTime &reference,
+                                 const PreciseDateTime &rtcTime) {
+  uint32_t t = reference.unixtime();
+  if (!count)
+    origin = t;
+  last = t;
+  count++;
+  // Welford's running covariance, numerically stable in single precision
+  float x = (int32_t)(t - origin) + reference.microsecond() * 1e-6f;
+  float y = (rtcTime - reference).totalmicroseconds() * 1e-6f;
+  float dx = x - meanX;
+  meanX += dx / count;
+  meanY += (y - meanY) / count;
+  sumXX += dx * (x - meanX);
+  sumXY += dx * (y - meanY);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Drift rate measured by the least-squares fit of the samples.
+    @return Drift in ppm, positive if the RTC runs fast, or 0 if the
+        samples do not span any time.
+*/
+/**************************************************************************/
+float DriftMeasurement::drift() const {
+  return sumXX > 0 ? sumXY / sumXX * 1e6f : 0;
+}
@@ -25,12 +25,35 @@
 #include <Adafruit_I2CDevice.h>
 #include <Arduino.h>
 
+/*
+  Compile-time feature switches, to leave out the parts of the library that
+  a firmware does not need. The library is compiled separately from the
+  sketch, so they must be defined as compiler flags, e.g. with
+  `--build-property compiler.cpp.extra_flags=-DRTCLIB_NO_STRING` for
+  arduino-cli, or in `build_flags` for PlatformIO:
+
+  - RTCLIB_NO_STRING removes the APIs returning a `String`
+  - RTCLIB_NO_12H removes 12-hour formatting: the "AP" and "ap" specifiers
+    of toString() and DateTimeFormat are then copied as is
+  - RTCLIB_NO_ISO8601 removes parseIso8601() and parseIso8601Lines()
+
+  extras/footprint.sh reports the flash and RAM used by each API.
+*/
+
 class TimeSpan;
 
 /** Constants */
 #define SECONDS_PER_DAY 86400L ///< 60 * 60 * 24
 #define SECONDS_FROM_1970_TO_2000                                              \
   946684800 ///< Unixtime for 2000-01-01 00:00:00, useful for initialization
+#define TIMESTAMP_NO_OFFSET 0x7FFF ///< timestamp() without a UTC offset
+/**
+  Buffer size for timestamp(char *) and preciseTimestamp(char *). The
+  longest timestamp has a fraction, an offset, and 3-digit fields if the
+  DateTime is out of range: "YYYY-MMM-DDDThhh:mmm:sss.ffffff+hh:mm".
+*/
+#define TIMESTAMP_BUFFER_SIZE 38
+#define TIMESTAMP_RECORD_SIZE 20 ///< Size of a TimestampFormatter record
 
 /** DS1307 SQW pin mode settings */
 enum Ds1307SqwPinMode {
@@ -146,6 +169,11 @@ public:
   DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0,
            uint8_t min = 0, uint8_t sec = 0);
   DateTime(const DateTime &copy);
+  /*!
+      @brief  Copy assignment.
+      @return Reference to this DateTime.
+  */
+  DateTime &operator=(const DateTime &) = default;
   DateTime(const char *date, const char *time);
   DateTime(const __FlashStringHelper *date, const __FlashStringHelper *time);
   DateTime(const char *iso8601date);
@@ -207,7 +235,13 @@ public:
     TIMESTAMP_TIME, //!< `hh:mm:ss`
     TIMESTAMP_DATE  //!< `YYYY-MM-DD`
   };
+#ifndef RTCLIB_NO_STRING
   String timestamp(timestampOpt opt = TIMESTAMP_FULL) const;
+#endif
+  size_t timestamp(char *buffer, timestampOpt opt = TIMESTAMP_FULL,
+                   int16_t offset = TIMESTAMP_NO_OFFSET) const;
+  size_t timestamp(Print &out, timestampOpt opt = TIMESTAMP_FULL,
+                   int16_t offset = TIMESTAMP_NO_OFFSET) const;
 
   DateTime operator+(const TimeSpan &span) const;
   DateTime operator-(const TimeSpan &span) const;
@@ -267,6 +301,188 @@ protected:
   uint8_t ss;   ///< Seconds 0-59
 };
 
+/**************************************************************************/
+/*!
+    @brief  DateTime packed into a 32-bit, order-preserving integer.
+
+    The fields are packed in year, month, day, hour, minute, second order,
+    as the digits of a mixed-radix number:
+
+    ```
+    ((((yOff * 12 + month - 1) * 31 + day - 1) * 24 + hh) * 60 + mm) * 60 + ss
+    ```
+
+    Packing all the fields as bitfields would need 33 bits, whereas this
+    encoding fits in 32 bits. As with bitfields, comparing two packed values
+    as unsigned integers gives the same result as comparing the DateTimes,
+    and packing only involves multiplications and additions. The conversion
+    is lossless for any DateTime with fields in range, including dates that
+    do not exist, like 31 February.
+*/
+/**************************************************************************/
+class PackedDateTime {
+public:
+  /*!
+      @brief  Create a PackedDateTime from its raw value.
+      @param raw Raw value, as returned by raw()
+  */
+  PackedDateTime(uint32_t raw = 0) : value(raw) {}
+  PackedDateTime(const DateTime &dt);
+  DateTime toDateTime() const;
+  /*!
+      @brief  Return the packed value.
+      @return The packed value, ordered like the DateTime.
+  */
+  uint32_t raw() const { return value; }
+  /*!
+      @brief  Return a hash of the value, suitable for hash tables indexed
+              by the high bits: `hash() >> (32 - bits)`.
+      @return Fibonacci hash of the packed value.
+  */
+  uint32_t hash() const { return value * 2654435769UL; }
+  /*!
+      @brief  Three-way comparison.
+      @param right PackedDateTime to compare with
+      @return Negative if this is earlier than `right`, 0 if they are equal,
+          positive if this is later.
+  */
+  int8_t compare(const PackedDateTime &right) const {
+    return (value > right.value) - (value < right.value);
+  }
+  /*!
+      @brief  Test if this is earlier than another PackedDateTime.
+      @param right PackedDateTime to compare with
+      @return True if this is earlier than `right`.
+  */
+  bool operator<(const PackedDateTime &right) const {
+    return value < right.value;
+  }
+  /*!
+      @brief  Test if this is equal to another PackedDateTime.
+      @param right PackedDateTime to compare with
+      @return True if both represent the same DateTime.
+  */
+  bool operator==(const PackedDateTime &right) const {
+    return value == right.value;
+  }
+  /*!
+      @brief  Test if this is different from another PackedDateTime.
+      @param right PackedDateTime to compare with
+      @return True if they represent different DateTimes.
+  */
+  bool operator!=(const PackedDateTime &right) const {
+    return value != right.value;
+  }
+
+protected:
+  uint32_t value; ///< Mixed-radix packed fields
+};
+
+#ifndef RTCLIB_NO_ISO8601
+/** Status of parseIso8601() */
+enum Iso8601Status {
+  ISO8601_OK = 0,     /**< Valid timestamp */
+  ISO8601_SYNTAX = 1, /**< Malformed timestamp */
+  ISO8601_RANGE = 2   /**< A field is out of range, or the date is outside
+                           2000--2099 */
+};
+
+/**************************************************************************/
+/*!
+    @brief  Result of parseIso8601().
+*/
+/**************************************************************************/
+struct Iso8601Result {
+  Iso8601Status status; ///< Whether the timestamp was valid
+  uint8_t length;       ///< Number of characters consumed
+  DateTime time;        ///< Date and time, as written in the timestamp
+  uint32_t fraction;    ///< Fraction of the second, in microseconds
+  int16_t offset; ///< UTC offset in minutes, or TIMESTAMP_NO_OFFSET if none
+};
+
+Iso8601Result parseIso8601(const char *str);
+size_t parseIso8601Lines(const char *text, uint32_t *times, size_t maxCount,
+                         const char **end = nullptr);
+#endif // RTCLIB_NO_ISO8601
+
+/** Maximum number of bytes read by each step of a split-phase transfer */
+#ifndef RTC_TRANSFER_CHUNK
+#define RTC_TRANSFER_CHUNK 2
+#endif
+
+/** Maximum number of operations in a DateTimeFormat */
+#ifndef DATETIMEFORMAT_MAX_OPS
+#define DATETIMEFORMAT_MAX_OPS 32
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Precompiled DateTime format.
+
+    The format string uses the same specifiers as DateTime::toString(). It
+    is parsed once, by the constructor, into a compact list of operations.
+    Each call to format() then renders a DateTime in a single pass, which is
+    much faster than toString() when the same format is used repeatedly:
+
+    ```
+    DateTimeFormat fmt("DDD, DD MMM YYYY hh:mm:ss");
+    char buffer[32]; // at least fmt.length() + 1
+    Serial.println(fmt.format(now, buffer));
+    ```
+
+    Each specifier and each literal character takes one operation. Formats
+    needing more than `DATETIMEFORMAT_MAX_OPS` operations are truncated.
+*/
+/**************************************************************************/
+class DateTimeFormat {
+public:
+  DateTimeFormat(const char *format);
+  char *format(const DateTime &dt, char *buffer) const;
+  /*!
+      @brief  Length of the formatted strings.
+      @return Number of characters written by format(), not counting the
+          terminating null character.
+  */
+  uint8_t length() const { return len; }
+
+protected:
+  uint8_t ops[DATETIMEFORMAT_MAX_OPS]; ///< Literal characters and specifiers
+  uint8_t nops;                        ///< Number of operations
+  uint8_t len;                         ///< Length of the output
+  bool twelveHour;                     ///< Whether "hh" is in 12-hour mode
+  bool needsDayOfWeek;                 ///< Whether "DDD" is used
+};
+
+/**************************************************************************/
+/*!
+    @brief  Fast conversion of Unix times to fixed-width ISO 8601 timestamps,
+            for exporting many records at once.
+
+    Each record is written as `YYYY-MM-DDThh:mm:ss` followed by a separator,
+    `TIMESTAMP_RECORD_SIZE` characters in total. The date part of the last
+    record is remembered, so that consecutive records falling on the same
+    day only cost the formatting of the time of day. The cache persists
+    across calls, which lets a log be exported in chunks:
+
+    ```
+    TimestampFormatter formatter;
+    char buffer[16 * TIMESTAMP_RECORD_SIZE];
+    size_t len = formatter.format(times, 16, buffer);
+    Serial.write(buffer, len);
+    ```
+*/
+/**************************************************************************/
+class TimestampFormatter {
+public:
+  size_t format(const uint32_t *times, size_t count, char *buffer,
+                char separator = '\n');
+  char *format(uint32_t t, char *buffer);
+
+protected:
+  uint32_t dayStart = 0; ///< Unix time of the start of the cached day
+  char date[11];         ///< Cached `YYYY-MM-DDT`, valid if dayStart != 0
+};
+
 /**************************************************************************/
 /*!
     @brief  Timespan which can represent changes in time with seconds accuracy.
@@ -320,200 +536,1710 @@ protected:
 
 /**************************************************************************/
 /*!
-    @brief  A generic I2C RTC base class. DO NOT USE DIRECTLY
+    @brief  TimeSpan with a microsecond resolution.
+
+    The span is `totalseconds()` seconds plus `microseconds()`
+    microseconds, where `microseconds()` is always in the range
+    0--999999. A span of -0.25&nbsp;s is thus stored as -1&nbsp;s plus
+    750000&nbsp;µs.
 */
 /**************************************************************************/
-class RTC_I2C {
-protected:
+class PreciseTimeSpan : public TimeSpan {
+public:
+  PreciseTimeSpan(int32_t seconds = 0, int32_t micros = 0);
   /*!
-      @brief  Convert a binary coded decimal value to binary. RTC stores
-    time/date values as BCD.
-      @param val BCD value
-      @return Binary value
+      @brief  Convert a TimeSpan.
+      @param span TimeSpan to convert
   */
-  static uint8_t bcd2bin(uint8_t val) { return val - 6 * (val >> 4); }
+  PreciseTimeSpan(const TimeSpan &span) : TimeSpan(span), _micros(0) {}
   /*!
-      @brief  Convert a binary value to BCD format for the RTC registers
-      @param val Binary value
-      @return BCD value
+      @brief  Copy constructor.
+      @param copy PreciseTimeSpan to copy
   */
-  static uint8_t bin2bcd(uint8_t val) { return val + 6 * (val / 10); }
-  Adafruit_I2CDevice *i2c_dev = NULL; ///< Pointer to I2C bus interface
-  uint8_t read_register(uint8_t reg);
-  void write_register(uint8_t reg, uint8_t val);
-};
+  PreciseTimeSpan(const PreciseTimeSpan &copy) = default;
+  /*!
+      @brief  Copy assignment.
+      @return Reference to this PreciseTimeSpan.
+  */
+  PreciseTimeSpan &operator=(const PreciseTimeSpan &) = default;
 
-/**************************************************************************/
-/*!
-    @brief  RTC based on the DS1307 chip connected via I2C and the Wire library
-*/
-/**************************************************************************/
-class RTC_DS1307 : RTC_I2C {
-public:
-  bool begin(TwoWire *wireInstance = &Wire);
-  void adjust(const DateTime &dt);
-  uint8_t isrunning(void);
-  DateTime now();
-  Ds1307SqwPinMode readSqwPinMode();
-  void writeSqwPinMode(Ds1307SqwPinMode mode);
-  uint8_t readnvram(uint8_t address);
-  void readnvram(uint8_t *buf, uint8_t size, uint8_t address);
-  void writenvram(uint8_t address, uint8_t data);
-  void writenvram(uint8_t address, const uint8_t *buf, uint8_t size);
-};
+  /*!
+      @brief  Milliseconds of the span, not counting the whole seconds
+      @return Milliseconds (0--999)
+  */
+  uint16_t milliseconds() const { return _micros / 1000; }
+  /*!
+      @brief  Microseconds of the span, not counting the whole seconds
+      @return Microseconds (0--999999)
+  */
+  uint32_t microseconds() const { return _micros; }
+  /*!
+      @brief  Total number of milliseconds, rounded down
+      @warning This overflows for spans longer than 24 days.
+      @return int32_t milliseconds
+  */
+  int32_t totalmilliseconds() const {
+    return _seconds * 1000 + (int32_t)(_micros / 1000);
+  }
+  /*!
+      @brief  Total number of microseconds
+      @return int64_t microseconds
+  */
+  int64_t totalmicroseconds() const {
+    return _seconds * (int64_t)1000000 + _micros;
+  }
 
-/**************************************************************************/
-/*!
-    @brief  RTC based on the DS3231 chip connected via I2C and the Wire library
-*/
-/**************************************************************************/
-class RTC_DS3231 : RTC_I2C {
-public:
-  bool begin(TwoWire *wireInstance = &Wire);
-  void adjust(const DateTime &dt);
-  bool lostPower(void);
-  DateTime now();
-  Ds3231SqwPinMode readSqwPinMode();
-  void writeSqwPinMode(Ds3231SqwPinMode mode);
-  bool setAlarm1(const DateTime &dt, Ds3231Alarm1Mode alarm_mode);
-  bool setAlarm2(const DateTime &dt, Ds3231Alarm2Mode alarm_mode);
-  DateTime getAlarm1();
-  DateTime getAlarm2();
-  Ds3231Alarm1Mode getAlarm1Mode();
-  Ds3231Alarm2Mode getAlarm2Mode();
-  void disableAlarm(uint8_t alarm_num);
-  void clearAlarm(uint8_t alarm_num);
-  bool alarmFired(uint8_t alarm_num);
-  void enable32K(void);
-  void disable32K(void);
-  bool isEnabled32K(void);
-  float getTemperature(); // in Celsius degree
   /*!
-      @brief  Convert the day of the week to a representation suitable for
-              storing in the DS3231: from 1 (Monday) to 7 (Sunday).
-      @param  d Day of the week as represented by the library:
-              from 0 (Sunday) to 6 (Saturday).
-      @return the converted value
+      @brief  Add two PreciseTimeSpans
+      @param right PreciseTimeSpan to add
+      @return Sum of left and right
   */
-  static uint8_t dowToDS3231(uint8_t d) { return d == 0 ? 7 : d; }
-};
+  PreciseTimeSpan operator+(const PreciseTimeSpan &right) const {
+    return PreciseTimeSpan(_seconds + right._seconds, _micros + right._micros);
+  }
+  /*!
+      @brief  Subtract a PreciseTimeSpan
+      @param right PreciseTimeSpan to subtract
+      @return Right subtracted from left
+  */
+  PreciseTimeSpan operator-(const PreciseTimeSpan &right) const {
+    return PreciseTimeSpan(_seconds - right._seconds,
+                           (int32_t)_micros - (int32_t)right._micros);
+  }
+  /*!
+      @brief  Test if one PreciseTimeSpan is shorter than another.
+      @param right PreciseTimeSpan to compare
+      @return True if the left span is shorter than the right one
+  */
+  bool operator<(const PreciseTimeSpan &right) const {
+    return _seconds < right._seconds ||
+           (_seconds == right._seconds && _micros < right._micros);
+  }
+  /*!
+      @brief  Test if one PreciseTimeSpan is longer than another.
+      @param right PreciseTimeSpan to compare
+      @return True if the left span is longer than the right one
+  */
+  bool operator>(const PreciseTimeSpan &right) const { return right < *this; }
+  /*!
+      @brief  Test if two PreciseTimeSpans are equal.
+      @param right PreciseTimeSpan to compare
+      @return True if both spans are equal
+  */
+  bool operator==(const PreciseTimeSpan &right) const {
+    return _seconds == right._seconds && _micros == right._micros;
+  }
+  /*!
+      @brief  Test if two PreciseTimeSpans are not equal.
+      @param right PreciseTimeSpan to compare
+      @return True if the spans differ
+  */
+  bool operator!=(const PreciseTimeSpan &right) const {
+    return !(*this == right);
+  }
 
-/**************************************************************************/
-/*!
-    @brief  RTC based on the PCF8523 chip connected via I2C and the Wire library
-*/
-/**************************************************************************/
-class RTC_PCF8523 : RTC_I2C {
-public:
-  bool begin(TwoWire *wireInstance = &Wire);
-  void adjust(const DateTime &dt);
-  bool lostPower(void);
-  bool initialized(void);
-  DateTime now();
-  void start(void);
-  void stop(void);
-  uint8_t isrunning();
-  Pcf8523SqwPinMode readSqwPinMode();
-  void writeSqwPinMode(Pcf8523SqwPinMode mode);
-  void enableSecondTimer(void);
-  void disableSecondTimer(void);
-  void enableCountdownTimer(PCF8523TimerClockFreq clkFreq, uint8_t numPeriods,
-                            uint8_t lowPulseWidth);
-  void enableCountdownTimer(PCF8523TimerClockFreq clkFreq, uint8_t numPeriods);
-  void disableCountdownTimer(void);
-  void deconfigureAllTimers(void);
-  void calibrate(Pcf8523OffsetMode mode, int8_t offset);
+protected:
+  uint32_t _micros; ///< Fraction of a second, 0--999999 microseconds
 };
 
 /**************************************************************************/
 /*!
-    @brief  RTC based on the PCF8563 chip connected via I2C and the Wire library
-*/
-/**************************************************************************/
-class RTC_PCF8563 : RTC_I2C {
-public:
-  bool begin(TwoWire *wireInstance = &Wire);
-  bool lostPower(void);
-  void adjust(const DateTime &dt);
-  DateTime now();
-  void start(void);
-  void stop(void);
-  uint8_t isrunning();
-  Pcf8563SqwPinMode readSqwPinMode();
-  void writeSqwPinMode(Pcf8563SqwPinMode mode);
-};
+    @brief  DateTime with a microsecond resolution.
 
-/**************************************************************************/
-/*!
-    @brief  RTC using the internal millis() clock, has to be initialized before
-   use. NOTE: this is immune to millis() rollover events.
+    This behaves like a DateTime, with an additional fraction of a second.
+    Arithmetic with PreciseTimeSpan and comparisons take the fraction into
+    account. A plain DateTime converts implicitly to a PreciseDateTime with
+    a zero fraction.
 */
 /**************************************************************************/
-class RTC_Millis {
+class PreciseDateTime : public DateTime {
 public:
+  PreciseDateTime(const DateTime &dt = DateTime(), uint32_t micros = 0);
   /*!
-      @brief  Start the RTC
-      @param dt DateTime object with the date/time to set
+      @brief  Copy constructor.
+      @param copy PreciseDateTime to copy
   */
-  void begin(const DateTime &dt) { adjust(dt); }
-  void adjust(const DateTime &dt);
-  DateTime now();
-
-protected:
+  PreciseDateTime(const PreciseDateTime &copy) = default;
   /*!
-      Unix time from the previous call to now().
+      @brief  Copy assignment.
+      @return Reference to this PreciseDateTime.
+  */
+  PreciseDateTime &operator=(const PreciseDateTime &) = default;
 
-      This, together with `lastMillis`, defines the alignment between
-      the `millis()` timescale and the Unix timescale. Both variables
-      are updated on each call to now(), which prevents rollover issues.
+  /*!
+      @brief  Return the milliseconds of the current second.
+      @return Milliseconds (0--999).
   */
-  uint32_t lastUnix;
+  uint16_t millisecond() const { return _micros / 1000; }
   /*!
-      `millis()` value corresponding `lastUnix`.
+      @brief  Return the microseconds of the current second.
+      @return Microseconds (0--999999).
+  */
+  uint32_t microsecond() const { return _micros; }
 
-      Note that this is **not** the `millis()` value of the last call to
-      now(): it's the `millis()` value corresponding to the last **full
-      second** of Unix time preceding the last call to now().
+  size_t preciseTimestamp(char *buffer, uint8_t digits = 3,
+                          int16_t offset = TIMESTAMP_NO_OFFSET) const;
+  size_t preciseTimestamp(Print &out, uint8_t digits = 3,
+                          int16_t offset = TIMESTAMP_NO_OFFSET) const;
+
+  PreciseDateTime operator+(const PreciseTimeSpan &span) const;
+  PreciseDateTime operator-(const PreciseTimeSpan &span) const;
+  PreciseTimeSpan operator-(const PreciseDateTime &right) const;
+  bool operator<(const PreciseDateTime &right) const;
+  /*!
+      @brief  Test if one PreciseDateTime is later than another.
+      @param right PreciseDateTime to compare
+      @return True if the left PreciseDateTime is later than the right one
   */
-  uint32_t lastMillis;
+  bool operator>(const PreciseDateTime &right) const { return right < *this; }
+  /*!
+      @brief  Test if one PreciseDateTime is not later than another.
+      @param right PreciseDateTime to compare
+      @return True if the left PreciseDateTime is earlier or equal
+  */
+  bool operator<=(const PreciseDateTime &right) const {
+    return !(right < *this);
+  }
+  /*!
+      @brief  Test if one PreciseDateTime is not earlier than another.
+      @param right PreciseDateTime to compare
+      @return True if the left PreciseDateTime is later or equal
+  */
+  bool operator>=(const PreciseDateTime &right) const {
+    return !(*this < right);
+  }
+  /*!
+      @brief  Test if two PreciseDateTime objects are equal.
+      @param right PreciseDateTime to compare
+      @return True if both the times and the fractions are equal
+  */
+  bool operator==(const PreciseDateTime &right) const {
+    return DateTime::operator==(right) && _micros == right._micros;
+  }
+  /*!
+      @brief  Test if two PreciseDateTime objects are not equal.
+      @param right PreciseDateTime to compare
+      @return True if the objects differ
+  */
+  bool operator!=(const PreciseDateTime &right) const {
+    return !(*this == right);
+  }
+
+protected:
+  uint32_t _micros; ///< Fraction of a second, 0--999999 microseconds
 };
 
 /**************************************************************************/
 /*!
-    @brief  RTC using the internal micros() clock, has to be initialized before
-            use. Unlike RTC_Millis, this can be tuned in order to compensate for
-            the natural drift of the system clock. Note that now() has to be
-            called more frequently than the micros() rollover period, which is
-            approximately 71.6 minutes.
+    @brief  Timespan with a 64-bit number of seconds, for intervals longer
+            than the 68 years of TimeSpan.
 */
 /**************************************************************************/
-class RTC_Micros {
+class TimeSpan64 {
 public:
   /*!
-      @brief  Start the RTC
-      @param dt DateTime object with the date/time to set
+      @brief  Create a TimeSpan64 from a number of seconds.
+      @param seconds Number of seconds
   */
-  void begin(const DateTime &dt) { adjust(dt); }
-  void adjust(const DateTime &dt);
-  void adjustDrift(int ppm);
-  DateTime now();
+  TimeSpan64(int64_t seconds = 0) : _seconds(seconds) {}
+  TimeSpan64(int32_t days, int8_t hours, int8_t minutes, int8_t seconds);
+  /*!
+      @brief  Convert a TimeSpan.
+      @param span TimeSpan to convert
+  */
+  TimeSpan64(const TimeSpan &span) : _seconds(span.totalseconds()) {}
 
-protected:
   /*!
-      Number of microseconds reported by `micros()` per "true"
-      (calibrated) second.
+      @brief  Number of days in the TimeSpan64
+      @return int32_t days
   */
-  uint32_t microsPerSecond = 1000000;
+  int32_t days() const { return _seconds / 86400L; }
   /*!
-      Unix time from the previous call to now().
-
-      The timing logic is identical to RTC_Millis.
+      @brief  Number of hours in the TimeSpan64, not counting the days
+      @return int8_t hours
   */
-  uint32_t lastUnix;
+  int8_t hours() const { return _seconds / 3600 % 24; }
   /*!
-      `micros()` value corresponding to `lastUnix`.
+      @brief  Number of minutes in the TimeSpan64, not counting the
+              days and hours
+      @return int8_t minutes
   */
-  uint32_t lastMicros;
+  int8_t minutes() const { return _seconds / 60 % 60; }
+  /*!
+      @brief  Number of seconds in the TimeSpan64, not counting the
+              days, hours and minutes
+      @return int8_t seconds
+  */
+  int8_t seconds() const { return _seconds % 60; }
+  /*!
+      @brief  Total number of seconds in the TimeSpan64
+      @return int64_t seconds
+  */
+  int64_t totalseconds() const { return _seconds; }
+
+  /*!
+      @brief  Add two TimeSpan64
+      @param right TimeSpan64 to add
+      @return Sum of left and right
+  */
+  TimeSpan64 operator+(const TimeSpan64 &right) const {
+    return TimeSpan64(_seconds + right._seconds);
+  }
+  /*!
+      @brief  Subtract a TimeSpan64
+      @param right TimeSpan64 to subtract
+      @return Right subtracted from left
+  */
+  TimeSpan64 operator-(const TimeSpan64 &right) const {
+    return TimeSpan64(_seconds - right._seconds);
+  }
+
+protected:
+  int64_t _seconds; ///< Actual TimeSpan64 value is stored as seconds
+};
+
+/**************************************************************************/
+/*!
+    @brief  Date/time class with an extended range, based on a 64-bit Unix
+            time.
+
+    Like DateTime, this class stores the date and time in broken-down form
+    and has no notion of time zones, DST or leap seconds. It supports the
+    proleptic Gregorian calendar over years 1--9999, using constant-time
+    conversions to and from Unix time. Conversions to and from DateTime
+    copy the fields, without any date calculation.
+*/
+/**************************************************************************/
+class DateTime64 {
+public:
+  DateTime64(int64_t t = 0);
+  DateTime64(int16_t year, uint8_t month, uint8_t day, uint8_t hour = 0,
+             uint8_t min = 0, uint8_t sec = 0);
+  DateTime64(const DateTime &dt);
+  DateTime toDateTime() const;
+  bool isValid() const;
+
+  /*!
+      @brief  Return the year.
+      @return Year (range: 1--9999).
+  */
+  int16_t year() const { return y; }
+  /*!
+      @brief  Return the month.
+      @return Month number (1--12).
+  */
+  uint8_t month() const { return m; }
+  /*!
+      @brief  Return the day of the month.
+      @return Day of the month (1--31).
+  */
+  uint8_t day() const { return d; }
+  /*!
+      @brief  Return the hour
+      @return Hour (0--23).
+  */
+  uint8_t hour() const { return hh; }
+  /*!
+      @brief  Return the minute.
+      @return Minute (0--59).
+  */
+  uint8_t minute() const { return mm; }
+  /*!
+      @brief  Return the second.
+      @return Second (0--59).
+  */
+  uint8_t second() const { return ss; }
+  uint8_t dayOfTheWeek() const;
+  int64_t unixtime() const;
+
+  DateTime64 operator+(const TimeSpan64 &span) const;
+  DateTime64 operator-(const TimeSpan64 &span) const;
+  TimeSpan64 operator-(const DateTime64 &right) const;
+  bool operator<(const DateTime64 &right) const;
+  /*!
+      @brief  Test if one DateTime64 is later than another.
+      @param right DateTime64 object to compare
+      @return True if the left DateTime64 is later than the right one
+  */
+  bool operator>(const DateTime64 &right) const { return right < *this; }
+  /*!
+      @brief  Test if one DateTime64 is earlier than or equal to another.
+      @param right DateTime64 object to compare
+      @return True if the left DateTime64 is not later than the right one
+  */
+  bool operator<=(const DateTime64 &right) const { return !(right < *this); }
+  /*!
+      @brief  Test if one DateTime64 is later than or equal to another.
+      @param right DateTime64 object to compare
+      @return True if the left DateTime64 is not earlier than the right one
+  */
+  bool operator>=(const DateTime64 &right) const { return !(*this < right); }
+  bool operator==(const DateTime64 &right) const;
+  /*!
+      @brief  Test if two DateTime64 objects are not equal.
+      @param right DateTime64 object to compare
+      @return True if the two objects are not equal
+  */
+  bool operator!=(const DateTime64 &right) const { return !(*this == right); }
+
+protected:
+  int16_t y;  ///< Year
+  uint8_t m;  ///< Month 1-12
+  uint8_t d;  ///< Day 1-31
+  uint8_t hh; ///< Hours 0-23
+  uint8_t mm; ///< Minutes 0-59
+  uint8_t ss; ///< Seconds 0-59
+};
+
+/**************************************************************************/
+/*!
+    @brief  Time zone and daylight saving time rules, as given by a POSIX
+            `TZ` string.
+
+    The rules are written as in the `TZ` environment variable, e.g.
+    `"CET-1CEST,M3.5.0,M10.5.0/3"` for central Europe. Note that POSIX
+    offsets count hours *west* of Greenwich. The transition instants are
+    computed once per year and cached, so converting successive times
+    costs a couple of comparisons:
+
+    ```
+    TimeZone tz;
+    tz.begin("CET-1CEST,M3.5.0,M10.5.0/3");
+    DateTime utc = rtc.now(); // RTC kept on UTC
+    DateTime local = tz.toLocal(utc);
+    local.timestamp(Serial, DateTime::TIMESTAMP_FULL, tz.offset(utc));
+    ```
+*/
+/**************************************************************************/
+class TimeZone {
+public:
+  TimeZone();
+  bool begin(const char *tz);
+  int16_t offset(const DateTime &utc);
+  bool isDST(const DateTime &utc);
+  const char *abbreviation(const DateTime &utc);
+  DateTime toLocal(const DateTime &utc);
+  DateTime toUTC(const DateTime &local);
+
+protected:
+  /*!
+      @brief  Rule giving the date and local time of a DST transition.
+  */
+  struct Rule {
+    char type;     ///< 'M' (month.week.day), 'J' (Julian day) or 'n' (day)
+    uint8_t month; ///< Month, for 'M' rules
+    uint8_t week;  ///< Week 1--5 (5: last), for 'M' rules
+    uint8_t wday;  ///< Day of the week (0: Sunday), for 'M' rules
+    uint16_t day;  ///< Day number, for 'J' and 'n' rules
+    int32_t time;  ///< Local time of the transition, in seconds
+  };
+  static const char *parseName(const char *p, char *name);
+  static const char *parseOffset(const char *p, int32_t &seconds);
+  static const char *parseRule(const char *p, Rule &rule);
+  static uint16_t ruleDay(const Rule &rule, uint16_t year, bool leap);
+  bool cacheYear(uint32_t t);
+
+  char stdName[8];       ///< Abbreviation of standard time, e.g. "CET"
+  char dstName[8];       ///< Abbreviation of DST, empty if there is no DST
+  int32_t stdOffset;     ///< Standard UTC offset in seconds, east positive
+  int32_t dstOffset;     ///< DST UTC offset in seconds, east positive
+  Rule dstStart;         ///< Start of DST
+  Rule dstEnd;           ///< End of DST
+  uint32_t yearStart;    ///< Unix time of the start of the cached year
+  uint32_t yearEnd;      ///< Unix time of the end of the cached year
+  uint32_t startInstant; ///< Unix time of the start of DST in that year
+  uint32_t endInstant;   ///< Unix time of the end of DST in that year
+};
+
+/**************************************************************************/
+/*!
+    @brief  Cron-style schedule, compiled to one bitmask per field.
+
+    The expression has the five fields of crontab (minute, hour, day of
+    the month, month, day of the week), optionally preceded by a sixth
+    field for the second. When the second is omitted it is taken as 0.
+    Each field is a comma-separated list of `*`, `n` or `n-m`, each
+    optionally followed by a step `/s`. Days of the week run from 0
+    (Sunday) to 7 (Sunday again). As in crontab, when both the day of the
+    month and the day of the week are restricted, a date matching either
+    matches.
+
+    ```
+    CronSchedule schedule;
+    schedule.begin("0,30 9-17 * * 1-5"); // every 30 min, office hours
+    DateTime next;
+    if (schedule.next(rtc.now(), next))
+      rtc.setAlarm1(next, DS3231_A1_Date);
+    ```
+*/
+/**************************************************************************/
+class CronSchedule {
+public:
+  CronSchedule();
+  bool begin(const char *expression);
+  bool match(const DateTime &dt) const;
+  bool next(const DateTime &after, DateTime &result) const;
+
+protected:
+  static const char *parseField(const char *p, uint8_t min, uint8_t max,
+                                uint64_t &mask);
+  bool matchDay(uint8_t day, uint8_t dow) const;
+
+  uint64_t seconds; ///< Bit n set if second n matches
+  uint64_t minutes; ///< Bit n set if minute n matches
+  uint32_t hours;   ///< Bit n set if hour n matches
+  uint32_t days;    ///< Bit n-1 set if day of the month n matches
+  uint16_t months;  ///< Bit n-1 set if month n matches
+  uint8_t weekdays; ///< Bit n set if day of the week n matches, 0: Sunday
+  bool anyDay;      ///< Day of the month field is `*`
+  bool anyWeekday;  ///< Day of the week field is `*`
+};
+
+/**************************************************************************/
+/*!
+    @brief  Measurement of the drift rate of an RTC against a reference
+            clock.
+
+    Pairs of reference and RTC times are accumulated in a running
+    least-squares fit, whose slope is the drift rate. Only the running
+    sums are kept, so any number of samples can be added. The object holds
+    no pointers, so it can be saved to EEPROM and restored, e.g. with
+    `EEPROM.put()` and `EEPROM.get()`, to carry a measurement across resets.
+*/
+/**************************************************************************/
+class DriftMeasurement {
+public:
+  DriftMeasurement();
+  void reset();
+  void addSample(const PreciseDateTime &reference,
+                 const PreciseDateTime &rtcTime);
+  /*!
+      @brief  Number of samples since the measurement started
+      @return Number of samples
+  */
+  uint16_t samples() const { return count; }
+  /*!
+      @brief  Time covered by the samples
+      @return Seconds between the first and the last reference times
+  */
+  uint32_t span() const { return last - origin; }
+  float drift() const;
+
+protected:
+  uint32_t origin; ///< Reference Unix time of the first sample
+  uint32_t last;   ///< Reference Unix time of the last sample
+  uint16_t count;  ///< Number of samples
+  float meanX;     ///< Mean reference time, seconds after `origin`
+  float meanY;     ///< Mean of RTC minus reference, in seconds
+  float sumXX;     ///< Sum of squared deviations of the reference times
+  float sumXY;     ///< Sum of products of deviations
+};
+
+/**************************************************************************/
+/*!
+    @brief  Compile-time capabilities of an RTC class.
+
+    This is specialized for each RTC class of the library, and can be
+    specialized likewise for user-defined clocks deriving from
+    RTC_Interface.
+*/
+/**************************************************************************/
+template <class RTC> struct RTC_Traits {
+  static const bool hasLostPower = false;   ///< Detects loss of power
+  static const bool hasAlarms = false;      ///< Has a date/time alarm
+  static const bool hasNvram = false;       ///< Has battery-backed RAM
+  static const bool hasTemperature = false; ///< Has a temperature sensor
+  static const bool hasCountdown = false;   ///< Has a countdown timer
+  static const uint8_t nvramSize = 0;       ///< Bytes of battery-backed RAM
+};
+
+/** Tag selecting an implementation of RTC_Interface by capability */
+template <bool supported> struct RTC_Capability {};
+
+/**************************************************************************/
+/*!
+    @brief  Statically dispatched interface common to all the RTC classes.
+
+    Every RTC class of the library derives from `RTC_Interface<itself>`.
+    Generic code can thus take any of them, and the calls compile down to
+    direct calls to the actual class, with no virtual table:
+
+    ```
+    template <class RTC> void logTime(RTC_Interface<RTC> &rtc) {
+      if (rtc.lostPower())
+        return;
+      Serial.println(rtc.now().timestamp());
+      float celsius;
+      if (rtc.readTemperature(celsius))
+        Serial.println(celsius);
+    }
+    ```
+
+    The optional features work on every class, and return false on those
+    lacking them. RTC_Traits tells at compile time which ones are
+    available.
+*/
+/**************************************************************************/
+template <class Derived> class RTC_Interface {
+public:
+  /** Capabilities of the RTC */
+  typedef RTC_Traits<Derived> Traits;
+
+  /*!
+      @brief  Get the current date/time.
+      @return DateTime object containing the current date/time
+  */
+  DateTime now() { return derived().now(); }
+
+  /*!
+      @brief  Set the current date/time.
+      @param dt DateTime object containing the date/time to set
+  */
+  void adjust(const DateTime &dt) { derived().adjust(dt); }
+
+  /*!
+      @brief  Check whether the RTC lost power, and its time is not valid.
+      @return True if the RTC lost power since the time was last set. Always
+          false for clocks not detecting it.
+  */
+  bool lostPower() {
+    return lostPower(RTC_Capability<Traits::hasLostPower>());
+  }
+
+  /*!
+      @brief  Read the temperature sensor of the RTC.
+      @param[out] celsius Receives the temperature in degrees Celsius
+      @return False if the RTC has no temperature sensor.
+  */
+  bool readTemperature(float &celsius) {
+    return readTemperature(celsius,
+                           RTC_Capability<Traits::hasTemperature>());
+  }
+
+  /*!
+      @brief  Read the battery-backed RAM of the RTC.
+      @param address Starting address, from 0
+      @param buf Buffer receiving the data
+      @param size Number of bytes to read
+      @return False if the RTC has no RAM, or if the range exceeds it.
+  */
+  bool readNvram(uint8_t address, uint8_t *buf, uint8_t size) {
+    if (address + size > Traits::nvramSize)
+      return false;
+    return readNvram(address, buf, size, RTC_Capability<Traits::hasNvram>());
+  }
+
+  /*!
+      @brief  Write the battery-backed RAM of the RTC.
+      @param address Starting address, from 0
+      @param buf Data to write
+      @param size Number of bytes to write
+      @return False if the RTC has no RAM, or if the range exceeds it.
+  */
+  bool writeNvram(uint8_t address, const uint8_t *buf, uint8_t size) {
+    if (address + size > Traits::nvramSize)
+      return false;
+    return writeNvram(address, buf, size, RTC_Capability<Traits::hasNvram>());
+  }
+
+  /*!
+      @brief  Set the alarm of the RTC to go off when the date (day of the
+              month) and time match, and clear any previous alarm.
+      @param dt DateTime object containing the alarm date/time
+      @return False if the RTC has no alarm, or if it cannot signal it, e.g.
+          a DS3231 whose SQW pin outputs a square wave.
+  */
+  bool armAlarm(const DateTime &dt) {
+    return armAlarm(dt, RTC_Capability<Traits::hasAlarms>());
+  }
+
+  /*!
+      @brief  Disable the alarm set by armAlarm().
+      @return False if the RTC has no alarm.
+  */
+  bool disarmAlarm() {
+    return disarmAlarm(RTC_Capability<Traits::hasAlarms>());
+  }
+
+  /*!
+      @brief  Check whether the alarm set by armAlarm() went off, and if so
+              clear it.
+      @return True if the alarm went off. Always false if the RTC has no
+          alarm.
+  */
+  bool takeAlarm() { return takeAlarm(RTC_Capability<Traits::hasAlarms>()); }
+
+  /*!
+      @brief  Start the countdown timer of the RTC, which signals the
+              interrupt pin when it expires.
+      @param seconds Duration of the countdown, 1 to 255 seconds
+      @return False if the RTC has no countdown timer, or if `seconds` is 0.
+  */
+  bool startCountdown(uint8_t seconds) {
+    if (!seconds)
+      return false;
+    return startCountdown(seconds, RTC_Capability<Traits::hasCountdown>());
+  }
+
+  /*!
+      @brief  Stop the countdown timer started by startCountdown().
+      @return False if the RTC has no countdown timer.
+  */
+  bool stopCountdown() {
+    return stopCountdown(RTC_Capability<Traits::hasCountdown>());
+  }
+
+protected:
+  /*!
+      @brief  Access the actual RTC object.
+      @return This object as its most derived class.
+  */
+  Derived &derived() { return *static_cast<Derived *>(this); }
+
+  /// @cond INTERNAL
+  bool lostPower(RTC_Capability<true>) { return derived().lostPower(); }
+  bool lostPower(RTC_Capability<false>) { return false; }
+  bool readTemperature(float &celsius, RTC_Capability<true>) {
+    celsius = derived().getTemperature();
+    return true;
+  }
+  bool readTemperature(float &, RTC_Capability<false>) { return false; }
+  bool readNvram(uint8_t address, uint8_t *buf, uint8_t size,
+                 RTC_Capability<true>) {
+    derived().readnvram(buf, size, address);
+    return true;
+  }
+  bool readNvram(uint8_t, uint8_t *, uint8_t, RTC_Capability<false>) {
+    return false;
+  }
+  bool writeNvram(uint8_t address, const uint8_t *buf, uint8_t size,
+                  RTC_Capability<true>) {
+    derived().writenvram(address, buf, size);
+    return true;
+  }
+  bool writeNvram(uint8_t, const uint8_t *, uint8_t, RTC_Capability<false>) {
+    return false;
+  }
+  bool armAlarm(const DateTime &dt, RTC_Capability<true>) {
+    derived().clearAlarm(1);
+    return derived().setAlarm1(dt, DS3231_A1_Date);
+  }
+  bool armAlarm(const DateTime &, RTC_Capability<false>) { return false; }
+  bool disarmAlarm(RTC_Capability<true>) {
+    derived().disableAlarm(1);
+    derived().clearAlarm(1);
+    return true;
+  }
+  bool disarmAlarm(RTC_Capability<false>) { return false; }
+  bool takeAlarm(RTC_Capability<true>) {
+    if (!derived().alarmFired(1))
+      return false;
+    derived().clearAlarm(1);
+    return true;
+  }
+  bool takeAlarm(RTC_Capability<false>) { return false; }
+  bool startCountdown(uint8_t seconds, RTC_Capability<true>) {
+    derived().enableCountdownTimer(PCF8523_FrequencySecond, seconds);
+    return true;
+  }
+  bool startCountdown(uint8_t, RTC_Capability<false>) { return false; }
+  bool stopCountdown(RTC_Capability<true>) {
+    derived().disableCountdownTimer();
+    return true;
+  }
+  bool stopCountdown(RTC_Capability<false>) { return false; }
+  /// @endcond
+};
+
+/**************************************************************************/
+/*!
+    @brief  A generic I2C RTC base class. DO NOT USE DIRECTLY
+*/
+/**************************************************************************/
+class RTC_I2C {
+protected:
+  /*!
+      @brief  Convert a binary coded decimal value to binary. RTC stores
+    time/date values as BCD.
+      @param val BCD value
+      @return Binary value
+  */
+  static uint8_t bcd2bin(uint8_t val) { return val - 6 * (val >> 4); }
+  /*!
+      @brief  Convert a binary value to BCD format for the RTC registers
+      @param val Binary value
+      @return BCD value
+  */
+  static uint8_t bin2bcd(uint8_t val) { return val + 6 * (val / 10); }
+  /*!
+      @brief  Create the RTC. The I2C device is set up by begin().
+  */
+  RTC_I2C() : device(0) {}
+  bool beginDevice(uint8_t addr, TwoWire *wireInstance);
+  Adafruit_I2CDevice device;          ///< I2C bus interface, set by begin()
+  Adafruit_I2CDevice *i2c_dev = NULL; ///< Pointer to `device` once begun
+  uint8_t read_register(uint8_t reg);
+  void write_register(uint8_t reg, uint8_t val);
+
+  void startRead(uint8_t reg, uint8_t len);
+  void startWrite(uint8_t reg, const uint8_t *data, uint8_t len);
+  bool stepTransfer(void);
+  uint8_t transferBuffer[7]; ///< Data of the split-phase transfer
+  uint8_t transferReg;       ///< First register of the transfer
+  uint8_t transferLen;       ///< Number of registers of the transfer
+  uint8_t transferPos;       ///< Number of registers read so far
+  uint8_t transferState = 0; ///< Next step of the transfer, 0 if idle
+};
+
+/**************************************************************************/
+/*!
+    @brief  RTC based on the DS1307 chip connected via I2C and the Wire library
+*/
+/**************************************************************************/
+class RTC_DS1307 : RTC_I2C, public RTC_Interface<RTC_DS1307> {
+public:
+  bool begin(TwoWire *wireInstance = &Wire);
+  void adjust(const DateTime &dt);
+  uint8_t isrunning(void);
+  bool lostPower(void);
+  DateTime now();
+  void requestNow(void);
+  bool pollNow(DateTime &dt);
+  void requestAdjust(const DateTime &dt);
+  bool pollAdjust(void);
+  Ds1307SqwPinMode readSqwPinMode();
+  void writeSqwPinMode(Ds1307SqwPinMode mode);
+  uint8_t readnvram(uint8_t address);
+  void readnvram(uint8_t *buf, uint8_t size, uint8_t address);
+  void writenvram(uint8_t address, uint8_t data);
+  void writenvram(uint8_t address, const uint8_t *buf, uint8_t size);
+
+protected:
+  static DateTime decodeTime(const uint8_t *regs);
+  static void encodeTime(const DateTime &dt, uint8_t *regs);
+};
+
+/**************************************************************************/
+/*!
+    @brief  Decoded contents of the DS3231 registers, as read in a single
+            I2C transaction by RTC_DS3231::getSnapshot().
+*/
+/**************************************************************************/
+struct Ds3231Snapshot {
+  DateTime now;                ///< Current date and time
+  DateTime alarm1;             ///< Alarm 1, as returned by getAlarm1()
+  Ds3231Alarm1Mode alarm1Mode; ///< Alarm 1 mode
+  DateTime alarm2;             ///< Alarm 2, as returned by getAlarm2()
+  Ds3231Alarm2Mode alarm2Mode; ///< Alarm 2 mode
+  Ds3231SqwPinMode sqwPinMode; ///< SQW pin mode, DS3231_OFF if INTCN is set
+  bool alarm1Enabled;          ///< A1IE: alarm 1 interrupt enabled
+  bool alarm2Enabled;          ///< A2IE: alarm 2 interrupt enabled
+  bool lostPower;              ///< OSF: the oscillator has stopped
+  bool busy;                   ///< BSY: temperature conversion in progress
+  bool alarm1Fired;            ///< A1F: alarm 1 has fired
+  bool alarm2Fired;            ///< A2F: alarm 2 has fired
+  bool enabled32K;             ///< EN32kHz: 32kHz output enabled
+  int8_t agingOffset;          ///< Aging offset register
+  float temperature;           ///< Temperature in Celsius degree
+};
+
+/**************************************************************************/
+/*!
+    @brief  RTC based on the DS3231 chip connected via I2C and the Wire library
+*/
+/**************************************************************************/
+class RTC_DS3231 : RTC_I2C, public RTC_Interface<RTC_DS3231> {
+public:
+  bool begin(TwoWire *wireInstance = &Wire);
+  void adjust(const DateTime &dt);
+  bool lostPower(void);
+  DateTime now();
+  void requestNow(void);
+  bool pollNow(DateTime &dt);
+  void requestAdjust(const DateTime &dt);
+  bool pollAdjust(void);
+  Ds3231SqwPinMode readSqwPinMode();
+  void writeSqwPinMode(Ds3231SqwPinMode mode);
+  bool setAlarm1(const DateTime &dt, Ds3231Alarm1Mode alarm_mode);
+  bool setAlarm2(const DateTime &dt, Ds3231Alarm2Mode alarm_mode);
+  DateTime getAlarm1();
+  DateTime getAlarm2();
+  Ds3231Alarm1Mode getAlarm1Mode();
+  Ds3231Alarm2Mode getAlarm2Mode();
+  void disableAlarm(uint8_t alarm_num);
+  void clearAlarm(uint8_t alarm_num);
+  bool alarmFired(uint8_t alarm_num);
+  void enable32K(void);
+  void disable32K(void);
+  bool isEnabled32K(void);
+  float getTemperature(); // in Celsius degree
+  int8_t readAgingOffset(void);
+  void writeAgingOffset(int8_t offset);
+  bool forceConversion(bool wait = true);
+  Ds3231Snapshot getSnapshot();
+  void enableRegisterCache(void);
+  void disableRegisterCache(void);
+  /*!
+      @brief  Convert the day of the week to a representation suitable for
+              storing in the DS3231: from 1 (Monday) to 7 (Sunday).
+      @param  d Day of the week as represented by the library:
+              from 0 (Sunday) to 6 (Saturday).
+      @return the converted value
+  */
+  static uint8_t dowToDS3231(uint8_t d) { return d == 0 ? 7 : d; }
+
+protected:
+  static DateTime decodeTime(const uint8_t *regs);
+  static void encodeTime(const DateTime &dt, uint8_t *regs);
+  static DateTime decodeAlarm1(const uint8_t *regs);
+  static DateTime decodeAlarm2(const uint8_t *regs);
+  static Ds3231Alarm1Mode decodeAlarm1Mode(const uint8_t *regs);
+  static Ds3231Alarm2Mode decodeAlarm2Mode(const uint8_t *regs);
+  static Ds3231SqwPinMode decodeSqwPinMode(uint8_t ctrl);
+  static float decodeTemperature(const uint8_t *regs);
+  uint8_t readControl(void);
+  void writeControl(uint8_t ctrl);
+  void updateStatus(uint8_t mask, uint8_t value);
+  bool registerCache = false; ///< Serve CONTROL and EN32kHz from the cache
+  uint8_t controlCache;       ///< Cached CONTROL register, CONV bit cleared
+  uint8_t statusCache;        ///< Cached EN32kHz bit of the STATUS register
+};
+
+/**************************************************************************/
+/*!
+    @brief  Any number of alarms multiplexed onto one DS3231 hardware alarm.
+
+    The alarms are kept in a priority queue, stored in an array supplied by
+    the caller. Only the earliest one is programmed into the chip, and the
+    chip is reprogrammed only when the earliest alarm changes. The SQW/INT
+    pin then wakes the MCU at each deadline, and poll() returns the
+    identifiers of the alarms that are due:
+
+    ```
+    AlarmScheduler::Entry entries[16];
+    AlarmScheduler scheduler(rtc, entries, 16);
+    ...
+    scheduler.begin();
+    scheduler.add(LOG_ID, rtc.now() + TimeSpan(60), 60); // every minute
+    ...
+    uint8_t id;
+    while (scheduler.poll(id)) {
+      ...
+    }
+    ```
+
+    Alarm 1 is used by default. Alarm 2 has a one-minute resolution, so
+    with it alarms fire at the start of the minute following their
+    deadline. As the chip matches the day of the month, a deadline more than
+    a month away may wake the MCU early; poll() then returns nothing.
+*/
+/**************************************************************************/
+class AlarmScheduler {
+public:
+  /*!
+      @brief  Queue entry of an AlarmScheduler.
+  */
+  struct Entry {
+    uint32_t time;   ///< Unix time of the next deadline
+    uint32_t period; ///< Repetition period in seconds, 0 for a single shot
+    uint8_t id;      ///< Identifier returned by poll()
+  };
+
+  AlarmScheduler(RTC_DS3231 &rtc, Entry *entries, uint8_t capacity,
+                 uint8_t alarm_num = 1);
+  bool begin();
+  bool add(uint8_t id, const DateTime &when, uint32_t period = 0);
+  bool remove(uint8_t id);
+  bool poll(uint8_t &id);
+  /*!
+      @brief  Number of scheduled alarms
+      @return Number of entries in the queue
+  */
+  uint8_t count() const { return size; }
+  /*!
+      @brief  Earliest deadline. Only valid if count() is not zero.
+      @return Date and time of the next alarm
+  */
+  DateTime next() const { return DateTime(heap[0].time); }
+
+protected:
+  void siftUp(uint8_t i);
+  void siftDown(uint8_t i);
+  void program(bool fired = false);
+
+  RTC_DS3231 &rtc;     ///< RTC providing the hardware alarm
+  Entry *heap;         ///< Binary min-heap of the entries, by time
+  uint8_t capacity;    ///< Size of the `heap` array
+  uint8_t size;        ///< Number of entries in the heap
+  uint8_t alarmNum;    ///< Hardware alarm used, 1 or 2
+  bool pending;        ///< The alarm fired and due entries remain to poll
+  uint32_t due;        ///< Time last read from the RTC
+  uint32_t programmed; ///< Deadline programmed into the chip, 0 if none
+};
+
+/**************************************************************************/
+/*!
+    @brief  Trimming of the DS3231 aging offset from a drift measurement.
+
+    The aging offset register adjusts the frequency of the DS3231 by about
+    0.1&nbsp;ppm per step. apply() adds the measured drift to the value
+    currently in the register, writes it, and forces a temperature
+    conversion so that it takes effect at once, rather than at the next
+    automatic conversion up to 64 seconds later. Repeating the measurement
+    over a few days converges the drift to a fraction of a ppm:
+
+    ```
+    Ds3231AgingTrim trim;
+    ...
+    // e.g. a few times a day, with the reference taken from NTP or GPS
+    trim.addSample(reference, rtc.now());
+    ...
+    if (trim.span() >= 3 * 86400UL && trim.apply(rtc)) {
+      Serial.println(trim.residual()); // ppm left uncorrected
+    }
+    ```
+
+    The DS3231 steps its frequency at each 64-second temperature
+    conversion, and only reports whole seconds, so the measurement should
+    span days rather than hours. Like DriftMeasurement, the object can be
+    saved to EEPROM.
+*/
+/**************************************************************************/
+class Ds3231AgingTrim : public DriftMeasurement {
+public:
+  /*!
+      @brief  Create an aging trim with no samples.
+  */
+  Ds3231AgingTrim() : residualPpm(0) {}
+  bool apply(RTC_DS3231 &rtc);
+  /*!
+      @brief  Drift that the last apply() could not correct, due to the
+              granularity and range of the aging offset register.
+      @return Residual drift in ppm, positive if the RTC is still fast
+  */
+  float residual() const { return residualPpm; }
+
+protected:
+  float residualPpm; ///< Drift left by the last apply()
+};
+
+/**************************************************************************/
+/*!
+    @brief  RTC based on the PCF8523 chip connected via I2C and the Wire library
+*/
+/**************************************************************************/
+class RTC_PCF8523 : RTC_I2C, public RTC_Interface<RTC_PCF8523> {
+public:
+  bool begin(TwoWire *wireInstance = &Wire);
+  void adjust(const DateTime &dt);
+  bool lostPower(void);
+  bool initialized(void);
+  DateTime now();
+  void requestNow(void);
+  bool pollNow(DateTime &dt);
+  void requestAdjust(const DateTime &dt);
+  bool pollAdjust(void);
+  void start(void);
+  void stop(void);
+  uint8_t isrunning();
+  Pcf8523SqwPinMode readSqwPinMode();
+  void writeSqwPinMode(Pcf8523SqwPinMode mode);
+  void enableSecondTimer(void);
+  void disableSecondTimer(void);
+  void enableCountdownTimer(PCF8523TimerClockFreq clkFreq, uint8_t numPeriods,
+                            uint8_t lowPulseWidth);
+  void enableCountdownTimer(PCF8523TimerClockFreq clkFreq, uint8_t numPeriods);
+  void disableCountdownTimer(void);
+  void deconfigureAllTimers(void);
+  void calibrate(Pcf8523OffsetMode mode, int8_t offset);
+
+protected:
+  static DateTime decodeTime(const uint8_t *regs);
+  static void encodeTime(const DateTime &dt, uint8_t *regs);
+};
+
+/**************************************************************************/
+/*!
+    @brief  Offset calibration of a PCF8523 from a drift measurement.
+
+    apply() picks the offset mode and value that best cancel the measured
+    drift, writes them to the RTC and starts a new measurement:
+
+    ```
+    Pcf8523Calibration calibration;
+    ...
+    // e.g. once a day, with the reference taken from NTP or GPS
+    calibration.addSample(reference, rtc.now());
+    ...
+    if (calibration.span() >= 7 * 86400UL && calibration.apply(rtc)) {
+      Serial.println(calibration.residual()); // ppm left uncorrected
+    }
+    ```
+
+    The object remembers the calibration last applied, so measurements may
+    be taken with a calibration in effect. Like DriftMeasurement, it can be
+    saved to EEPROM.
+*/
+/**************************************************************************/
+class Pcf8523Calibration : public DriftMeasurement {
+public:
+  Pcf8523Calibration();
+  void begin(Pcf8523OffsetMode mode = PCF8523_TwoHours, int8_t offset = 0);
+  bool apply(RTC_PCF8523 &rtc);
+  /*!
+      @brief  Offset mode of the calibration in effect
+      @return Offset mode
+  */
+  Pcf8523OffsetMode mode() const { return (Pcf8523OffsetMode)offsetMode; }
+  /*!
+      @brief  Offset value of the calibration in effect
+      @return Offset, from -64 to +63
+  */
+  int8_t offset() const { return offsetValue; }
+  /*!
+      @brief  Drift that the last apply() could not correct, due to the
+              granularity and range of the offset register.
+      @return Residual drift in ppm, positive if the RTC is still fast
+  */
+  float residual() const { return residualPpm; }
+
+protected:
+  float residualPpm;  ///< Drift left by the last apply()
+  int8_t offsetValue; ///< Offset in effect
+  uint8_t offsetMode; ///< Pcf8523OffsetMode in effect
+};
+
+/**************************************************************************/
+/*!
+    @brief  RTC based on the PCF8563 chip connected via I2C and the Wire library
+*/
+/**************************************************************************/
+class RTC_PCF8563 : RTC_I2C, public RTC_Interface<RTC_PCF8563> {
+public:
+  bool begin(TwoWire *wireInstance = &Wire);
+  bool lostPower(void);
+  void adjust(const DateTime &dt);
+  DateTime now();
+  void requestNow(void);
+  bool pollNow(DateTime &dt);
+  void requestAdjust(const DateTime &dt);
+  bool pollAdjust(void);
+  void start(void);
+  void stop(void);
+  uint8_t isrunning();
+  Pcf8563SqwPinMode readSqwPinMode();
+  void writeSqwPinMode(Pcf8563SqwPinMode mode);
+
+protected:
+  static DateTime decodeTime(const uint8_t *regs);
+  static void encodeTime(const DateTime &dt, uint8_t *regs);
+};
+
+/**************************************************************************/
+/*!
+    @brief  RTC using the internal millis() clock, has to be initialized before
+   use. NOTE: this is immune to millis() rollover events.
+*/
+/**************************************************************************/
+class RTC_Millis : public RTC_Interface<RTC_Millis> {
+public:
+  /*!
+      @brief  Start the RTC
+      @param dt DateTime object with the date/time to set
+  */
+  void begin(const DateTime &dt) { adjust(dt); }
+  void adjust(const DateTime &dt);
+  void adjust(const PreciseDateTime &dt);
+  DateTime now();
+  PreciseDateTime nowPrecise();
+
+protected:
+  /*!
+      Unix time from the previous call to now().
+
+      This, together with `lastMillis`, defines the alignment between
+      the `millis()` timescale and the Unix timescale. Both variables
+      are updated on each call to now(), which prevents rollover issues.
+  */
+  uint32_t lastUnix;
+  /*!
+      `millis()` value corresponding `lastUnix`.
+
+      Note that this is **not** the `millis()` value of the last call to
+      now(): it's the `millis()` value corresponding to the last **full
+      second** of Unix time preceding the last call to now().
+  */
+  uint32_t lastMillis;
+};
+
+/**************************************************************************/
+/*!
+    @brief  RTC using the internal micros() clock, has to be initialized before
+            use. Unlike RTC_Millis, this can be tuned in order to compensate for
+            the natural drift of the system clock. Note that now() has to be
+            called more frequently than the micros() rollover period, which is
+            approximately 71.6 minutes.
+*/
+/**************************************************************************/
+class RTC_Micros : public RTC_Interface<RTC_Micros> {
+public:
+  /*!
+      @brief  Start the RTC
+      @param dt DateTime object with the date/time to set
+  */
+  void begin(const DateTime &dt) { adjust(dt); }
+  void adjust(const DateTime &dt);
+  void adjust(const PreciseDateTime &dt);
+  void adjustDrift(int ppm);
+  void adjustDriftPpb(int32_t ppb);
+  DateTime now();
+  PreciseDateTime nowPrecise();
+
+protected:
+  uint32_t advance();
+
+  /*!
+      Number of microseconds reported by `micros()` per "true"
+      (calibrated) second.
+  */
+  uint32_t microsPerSecond = 1000000;
+  /*!
+      Additional fraction of a microsecond per second, in units of
+      1/65536&nbsp;µs, set by adjustDriftPpb().
+  */
+  uint16_t microsFraction = 0;
+  /*!
+      Accumulated `microsFraction` not yet added to `lastMicros`.
+  */
+  uint16_t fractionAccumulator = 0;
+  /*!
+      Unix time from the previous call to now().
+
+      The timing logic is identical to RTC_Millis.
+  */
+  uint32_t lastUnix;
+  /*!
+      `micros()` value corresponding to `lastUnix`.
+  */
+  uint32_t lastMicros;
+};
+
+/** Capabilities of RTC_DS1307 */
+template <> struct RTC_Traits<RTC_DS1307> : RTC_Traits<void> {
+  static const bool hasLostPower = true; ///< Detects loss of power
+  static const bool hasNvram = true;     ///< Has battery-backed RAM
+  static const uint8_t nvramSize = 56;   ///< Bytes of battery-backed RAM
+};
+
+/** Capabilities of RTC_DS3231 */
+template <> struct RTC_Traits<RTC_DS3231> : RTC_Traits<void> {
+  static const bool hasLostPower = true;   ///< Detects loss of power
+  static const bool hasAlarms = true;      ///< Has a date/time alarm
+  static const bool hasTemperature = true; ///< Has a temperature sensor
+};
+
+/** Capabilities of RTC_PCF8523 */
+template <> struct RTC_Traits<RTC_PCF8523> : RTC_Traits<void> {
+  static const bool hasLostPower = true; ///< Detects loss of power
+  static const bool hasCountdown = true; ///< Has a countdown timer
+};
+
+/** Capabilities of RTC_PCF8563 */
+template <> struct RTC_Traits<RTC_PCF8563> : RTC_Traits<void> {
+  static const bool hasLostPower = true; ///< Detects loss of power
+};
+
+/**************************************************************************/
+/*!
+    @brief  Sub-second clock driven by the 1&nbsp;Hz square wave of an RTC.
+
+    The RTC is configured to output a 1&nbsp;Hz square wave (or the PCF8523
+    second timer), and the user attaches an interrupt handler calling tick()
+    to the edge on which the RTC increments its seconds. Each edge latches
+    `micros()`, which gives the fraction of the current second without any
+    I2C traffic:
+
+    ```
+    RTC_DS3231 rtc;
+    RTC_SqwClock clock;
+    void onTick() { clock.tick(); }
+    ...
+    rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
+    attachInterrupt(digitalPinToInterrupt(2), onTick, FALLING);
+    clock.begin(rtc);
+    ...
+    PreciseDateTime dt = clock.nowPrecise();
+    ```
+
+    If edges stop coming, the clock keeps running from `micros()`. Until
+    the first edge, the phase of the RTC is unknown: the time counts from
+    adjust() and the fraction of the second is 0.
+*/
+/**************************************************************************/
+class RTC_SqwClock {
+public:
+  /*!
+      @brief  Wait for the next edge and set the time from the RTC.
+      @param rtc The RTC generating the square wave: RTC_DS1307,
+          RTC_DS3231, RTC_PCF8523 or RTC_PCF8563
+      @return False if no edge was seen within 1.1 seconds, true otherwise.
+  */
+  template <class RTC> bool begin(RTC &rtc) {
+    if (!waitForTick())
+      return false;
+    adjust(rtc.now());
+    return true;
+  }
+  void adjust(const DateTime &dt);
+  void tick(void);
+  bool waitForTick(void);
+  DateTime now();
+  PreciseDateTime nowPrecise();
+
+protected:
+  volatile uint32_t tickUnix = 0;   ///< Unix time at the last edge
+  volatile uint32_t tickMicros = 0; ///< `micros()` at the last edge
+  volatile bool ticked = false;     ///< Whether an edge has been seen
+};
+
+/**************************************************************************/
+/*!
+    @brief  Front-end for a hardware RTC that serves now() without touching
+            the I2C bus.
+
+    The hardware RTC is read on the first call to now(), and then again once
+    every resync interval. In between, the time is extrapolated from
+    `micros()`. This works with RTC_DS1307, RTC_DS3231, RTC_PCF8523 and
+    RTC_PCF8563:
+
+    ```
+    RTC_DS3231 rtc;
+    RTC_Cached<RTC_DS3231> clock(rtc);
+    ...
+    DateTime now = clock.now(); // no I2C traffic most of the time
+    ```
+
+    The hardware RTC only reports whole seconds, so after a plain sync() the
+    extrapolated time may lag by up to one second. Each resync tightens the
+    phase whenever the RTC is seen ticking earlier than expected, and
+    syncToEdge() aligns it to a few hundred microseconds at the cost of
+    polling the RTC for up to one second. errorBound() reports the current
+    worst-case lag.
+*/
+/**************************************************************************/
+template <class RTC> class RTC_Cached {
+public:
+  /*!
+      @brief  Create a cached front-end for a hardware RTC.
+      @param rtc The RTC to read, on which begin() should have been called
+      @param resyncInterval Seconds between reads of the RTC (1--3600)
+  */
+  RTC_Cached(RTC &rtc, uint16_t resyncInterval = 60) : rtc(rtc) {
+    setResyncInterval(resyncInterval);
+  }
+
+  /*!
+      @brief  Set how often the hardware RTC is read.
+      @param seconds Seconds between reads of the RTC, capped at 3600 to
+          stay well within the `micros()` rollover period.
+  */
+  void setResyncInterval(uint16_t seconds) {
+    resyncInterval = seconds == 0 ? 1 : seconds > 3600 ? 3600 : seconds;
+  }
+
+  /*!
+      @brief  Set the maximum drift rate of `micros()`, used by errorBound().
+      @param ppm Drift rate in parts per million. Use about 100 for a
+          crystal and 5000 for a ceramic resonator.
+  */
+  void setDriftBound(uint16_t ppm) { driftPpm = ppm; }
+
+  /*!
+      @brief  Set the time of the hardware RTC and resync from it.
+      @param dt DateTime object with the date/time to set
+  */
+  void adjust(const DateTime &dt) {
+    rtc.adjust(dt);
+    synced = false;
+    sync();
+  }
+
+  /*!
+      @brief  Read the hardware RTC and realign the extrapolation.
+  */
+  void sync() {
+    uint32_t m = micros(); // the RTC latches its time right after this
+    uint32_t r = rtc.now().unixtime();
+    uint32_t elapsed = (m - anchorMicros) / 1000000;
+    phaseError += (uint32_t)driftPpm * ((m - syncMicros) / 1000000);
+    if (phaseError > 1000000)
+      phaseError = 1000000; // the RTC bounds the lag to one second
+    if (synced && anchorUnix + elapsed == r) {
+      // Consistent with the extrapolation: keep the phase we know
+      anchorMicros += elapsed * 1000000;
+    } else if (synced && anchorUnix + elapsed + 1 == r) {
+      // The RTC ticked earlier than extrapolated: after the earliest tick
+      // the phase we know allows, and before m
+      uint32_t earliest = anchorMicros - phaseError + (elapsed + 1) * 1000000;
+      phaseError = m - earliest;
+      if (phaseError > 1000000)
+        phaseError = 1000000; // the drift exceeded the bound
+      anchorMicros = m;
+    } else {
+      anchorMicros = m;
+      phaseError = 1000000;
+    }
+    anchorUnix = r;
+    syncMicros = m;
+    synced = true;
+  }
+
+  /*!
+      @brief  Align the extrapolation to the moment the hardware RTC ticks.
+      @details This polls the RTC until its seconds change, which blocks for
+      up to one second. If the RTC does not tick within 1.1 seconds, it falls
+      back to a plain sync().
+  */
+  void syncToEdge() {
+    uint32_t start = micros();
+    uint32_t first = rtc.now().unixtime();
+    uint32_t before = micros(), after = before, r = first;
+    while (r == first && after - start < 1100000) {
+      before = after;
+      r = rtc.now().unixtime();
+      after = micros();
+    }
+    if (r == first) {
+      synced = false;
+      sync();
+      return;
+    }
+    // The tick happened between the latching of the last two reads
+    anchorUnix = r;
+    anchorMicros = after;
+    phaseError = after - before;
+    syncMicros = after;
+    synced = true;
+  }
+
+  /*!
+      @brief  Get the current date/time, reading the hardware RTC only if
+              the resync interval has elapsed.
+      @return DateTime object containing the current date/time
+  */
+  DateTime now() {
+    if (!synced || micros() - syncMicros >= resyncInterval * 1000000UL)
+      sync();
+    return anchorUnix + (micros() - anchorMicros) / 1000000;
+  }
+
+  /*!
+      @brief  Maximum amount by which now() may lag behind the hardware RTC.
+      @return Error bound in microseconds: the uncertainty on the phase of
+          the RTC, one second at most, a few hundred microseconds after
+          syncToEdge(), plus the drift accumulated since the last sync.
+  */
+  uint32_t errorBound() const {
+    uint32_t drift = (uint32_t)driftPpm * ((micros() - syncMicros) / 1000000);
+    return phaseError + drift;
+  }
+
+protected:
+  RTC &rtc;                ///< Hardware RTC being cached
+  uint32_t anchorUnix;     ///< Unix time at `anchorMicros`
+  uint32_t anchorMicros;   ///< `micros()` at or just after the tick of
+                           ///< `anchorUnix`
+  uint32_t syncMicros;     ///< `micros()` at the last read of the RTC
+  uint32_t phaseError = 0; ///< Maximum lag of `anchorMicros`, in us
+  uint16_t resyncInterval; ///< Seconds between reads of the RTC
+  uint16_t driftPpm = 100; ///< Maximum drift rate of `micros()`
+  bool synced = false;     ///< Whether the RTC has been read at least once
+};
+
+/**************************************************************************/
+/*!
+    @brief  Closed-loop discipline of an RTC_Micros clock by a hardware RTC.
+
+    Each update() measures the offset of the RTC_Micros clock against the
+    moment the hardware RTC ticks, and feeds it to a phase-locked loop
+    which estimates the drift of `micros()` and corrects it through
+    RTC_Micros::adjustDriftPpb(). The RTC_Micros clock then serves the time
+    with no bus access, and stays within a few milliseconds of the RTC:
+
+    ```
+    RTC_DS3231 rtc;
+    RTC_Micros softClock;
+    RTC_Discipline<RTC_DS3231> discipline(rtc, softClock);
+    ...
+    discipline.update(); // sets the clock
+    ...
+    discipline.poll();   // in loop(), updates every 10 minutes
+    PreciseDateTime now = softClock.nowPrecise();
+    ```
+
+    Offsets larger than 128&nbsp;ms are corrected by stepping the clock,
+    after estimating the drift from them, smaller ones by slewing its rate,
+    so it never goes backwards once locked. Drifts up to 30,000&nbsp;ppm
+    are corrected. Each update() polls the RTC until it ticks, which blocks
+    for up to one second.
+*/
+/**************************************************************************/
+template <class RTC> class RTC_Discipline {
+public:
+  /*!
+      @brief  Create a discipline loop.
+      @param rtc The reference RTC, on which begin() should have been called
+      @param clock The clock to discipline
+      @param updateInterval Seconds between updates done by poll()
+  */
+  RTC_Discipline(RTC &rtc, RTC_Micros &clock, uint16_t updateInterval = 600)
+      : rtc(rtc), clock(clock) {
+    setUpdateInterval(updateInterval);
+  }
+
+  /*!
+      @brief  Set how often poll() updates the clock. Longer intervals
+              average out the timing noise of the measurements.
+      @param seconds Seconds between updates (16--3600), capped to stay
+          within the `micros()` rollover period.
+  */
+  void setUpdateInterval(uint16_t seconds) {
+    updateInterval = seconds < 16 ? 16 : seconds > 3600 ? 3600 : seconds;
+  }
+
+  /*!
+      @brief  Measure the offset of the clock and correct it.
+      @return False if the RTC did not tick within 1.1 seconds.
+  */
+  bool update() {
+    uint32_t start = micros();
+    uint32_t first = rtc.now().unixtime();
+    uint32_t before = micros(), after = before, r = first;
+    while (r == first && after - start < 1100000) {
+      before = after;
+      delay(1); // leave the bus to other devices between reads
+      r = rtc.now().unixtime();
+      after = micros();
+    }
+    if (r == first)
+      return false;
+    // The tick happened between the latching of the last two reads
+    PreciseDateTime reference(r, (after - before) / 2 + (micros() - after));
+    int64_t error = (clock.nowPrecise() - reference).totalmicroseconds();
+    // Beyond 1000 s, the offset only saturates the frequency estimate
+    if (error > 1000000000 || error < -1000000000)
+      error = error > 0 ? 1000000000 : -1000000000;
+    float interval = (after - lastUpdate) * 1e-6f;
+    lastUpdate = after;
+    measuredOffset = error;
+
+    if (state == 0) {
+      clock.adjust(reference);
+      measuredOffset = 0; // the clock was not set
+      frequencyPpm = 0;
+      state = 1;
+    } else if (error > 128000 || error < -128000) {
+      // Too far off to slew: estimate the frequency from the offset, so
+      // that a large drift still locks, then step
+      frequencyPpm = clampFrequency(frequencyPpm - error / interval);
+      clock.adjust(reference);
+      measuredOffset = 0;
+      state = 1;
+    } else {
+      float drift = error / interval; // ppm
+      if (state == 1) {
+        frequencyPpm -= drift; // first frequency measurement
+        state = 2;
+      } else {
+        frequencyPpm -= drift / 8;
+      }
+      frequencyPpm = clampFrequency(frequencyPpm);
+      // Slew half of the offset away over the next interval
+      clock.adjustDriftPpb((frequencyPpm - drift / 2) * 1000);
+      return true;
+    }
+    clock.adjustDriftPpb(frequencyPpm * 1000);
+    return true;
+  }
+
+  /*!
+      @brief  Call update() if the update interval has elapsed since the
+              last one. Call this often from the main loop.
+      @return True if an update was done.
+  */
+  bool poll() {
+    if (state && micros() - lastUpdate < updateInterval * 1000000UL)
+      return false;
+    return update();
+  }
+
+  /*!
+      @brief  Offset of the clock measured by the last update(), before it
+              was corrected.
+      @return Offset in microseconds, positive if the clock was ahead of
+          the RTC, or 0 if the update set or stepped the clock.
+  */
+  int32_t offset() const { return measuredOffset; }
+
+  /*!
+      @brief  Estimated drift correction of `micros()`.
+      @return Correction in ppm, positive if `micros()` runs slow.
+  */
+  float frequency() const { return frequencyPpm; }
+
+  /*!
+      @brief  Whether the drift of `micros()` has been measured.
+      @return True after the second successful update().
+  */
+  bool locked() const { return state == 2; }
+
+protected:
+  /*!
+      @brief  Limit a frequency correction to what RTC_Micros supports.
+      @param ppm Frequency correction
+      @return The correction, within &plusmn;30,000&nbsp;ppm, which leaves
+          room for the slewing of the offset.
+  */
+  static float clampFrequency(float ppm) {
+    return ppm > 30000 ? 30000 : ppm < -30000 ? -30000 : ppm;
+  }
+
+  RTC &rtc;                   ///< Reference RTC
+  RTC_Micros &clock;          ///< Disciplined clock
+  uint32_t lastUpdate = 0;    ///< `micros()` at the last RTC tick measured
+  int32_t measuredOffset = 0; ///< Offset measured by the last update, in us
+  float frequencyPpm = 0;     ///< Estimated correction of `micros()`
+  uint16_t updateInterval;    ///< Seconds between updates done by poll()
+  uint8_t state = 0;          ///< 0: unset, 1: clock set, 2: locked
+};
+
+/** Maximum number of members of an RTC_Redundant */
+#ifndef RTC_REDUNDANT_MAX_MEMBERS
+#define RTC_REDUNDANT_MAX_MEMBERS 4
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Composite clock that votes between several RTCs.
+
+    Each now() reads the members one after the other, skipping any that
+    lost power, until a majority of the others agree within the tolerance.
+    It returns the median of the agreeing readings, and re-adjusts the
+    members that lost power or disagreed:
+
+    ```
+    RTC_DS3231 ds3231;
+    RTC_PCF8523 pcf8523;
+    RTC_Redundant clock;
+    ...
+    clock.add(ds3231);
+    clock.add(pcf8523);
+    ...
+    DateTime now = clock.now();
+    if (clock.confidence() < clock.majority())
+      ...; // no two clocks agree, do not trust the time
+    ```
+
+    Power loss is checked once for each member, when it is added, and
+    again only for the members that disagree when there is no majority, so
+    that queries read nothing but the time. With three healthy members, a
+    query thus reads only two of them. The
+    member read first rotates from one query to the next, so that each
+    member gets checked regularly. The members can be any mix of RTC_DS1307,
+    RTC_DS3231, RTC_PCF8523, RTC_PCF8563, RTC_Millis and RTC_Micros, on the
+    same bus or not.
+*/
+/**************************************************************************/
+class RTC_Redundant {
+public:
+  /*!
+      @brief  Add a member clock.
+      @param rtc The clock, on which begin() should have been called
+      @return False if there are already `RTC_REDUNDANT_MAX_MEMBERS`
+          members.
+  */
+  template <class RTC> bool add(RTC &rtc) {
+    if (count == RTC_REDUNDANT_MAX_MEMBERS)
+      return false;
+    uint8_t i = count++;
+    Member &member = members[i];
+    member.rtc = &rtc;
+    member.now = &memberNow<RTC>;
+    member.adjust = &memberAdjust<RTC>;
+    member.lostPower = &memberLostPower<RTC>;
+    if (member.lostPower(member.rtc))
+      lostMask |= 1 << i;
+    return true;
+  }
+  void setTolerance(uint8_t seconds);
+  void adjust(const DateTime &dt);
+  DateTime now();
+  /*!
+      @brief  Number of members.
+      @return Number of clocks added.
+  */
+  uint8_t size() const { return count; }
+  uint8_t majority() const;
+  /*!
+      @brief  Number of members that agreed on the time returned by the last
+              now().
+      @return At least majority() if the time is a consensus, 0 if no
+          member could be read.
+  */
+  uint8_t confidence() const { return agreeing; }
+  /*!
+      @brief  Members found faulty by the last now().
+      @return Bit mask with bit `i` set if member `i` (in the order they
+          were added) lost power or disagreed with the time returned.
+  */
+  uint8_t faults() const { return faultMask; }
+
+protected:
+  /** Type-erased access to a member clock */
+  struct Member {
+    void *rtc;                                ///< The clock
+    DateTime (*now)(void *);                  ///< Calls `now()`
+    void (*adjust)(void *, const DateTime &); ///< Calls `adjust()`
+    bool (*lostPower)(void *);                ///< Calls `lostPower()`
+  };
+
+  /*!
+      @brief  Read a member clock.
+      @param rtc The clock
+      @return The current date/time of the clock.
+  */
+  template <class RTC> static DateTime memberNow(void *rtc) {
+    return static_cast<RTC *>(rtc)->now();
+  }
+  /*!
+      @brief  Set a member clock.
+      @param rtc The clock
+      @param dt The date/time to set
+  */
+  template <class RTC>
+  static void memberAdjust(void *rtc, const DateTime &dt) {
+    static_cast<RTC *>(rtc)->adjust(dt);
+  }
+  /*!
+      @brief  Check whether a member clock lost power.
+      @param rtc The clock
+      @return True if the time of the clock cannot be trusted.
+  */
+  template <class RTC> static bool memberLostPower(void *rtc) {
+    return static_cast<RTC_Interface<RTC> *>(static_cast<RTC *>(rtc))
+        ->lostPower();
+  }
+
+  uint8_t cluster(const uint32_t *times, uint8_t n, uint8_t &center) const;
+
+  Member members[RTC_REDUNDANT_MAX_MEMBERS]; ///< Member clocks
+
+  uint8_t count = 0;     ///< Number of members
+  uint8_t first = 0;     ///< Member read first by the next now()
+  uint8_t tolerance = 2; ///< Maximum difference between agreeing members
+  uint8_t agreeing = 0;  ///< Members agreeing at the last now()
+  uint8_t faultMask = 0; ///< Members found faulty at the last now()
+  uint8_t lostMask = 0;  ///< Members that lost power and were not set since
 };
 
 #endif // _RTCLIB_H_
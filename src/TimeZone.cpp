@@ -0,0 +1,273 @@
+#include "RTClib.h"
+
+/**************************************************************************/
+/*!
+    @brief  Create a TimeZone representing UTC, with no DST.
+*/
+/**************************************************************************/
+TimeZone::TimeZone()
+    : stdName("UTC"), dstName(""), stdOffset(0), dstOffset(0), yearStart(0),
+      yearEnd(0) {}
+
+/**************************************************************************/
+/*!
+    @brief  Parse a time zone abbreviation, either alphabetic (e.g. "CET")
+            or quoted (e.g. "<+03>").
+    @param p String to parse
+    @param[out] name Receives the null-terminated abbreviation
+    @return Pointer past the abbreviation, or NULL if it is invalid.
+*/
+/**************************************************************************/
+const char *TimeZone::parseName(const char *p, char *name) {
+  bool quoted = *p == '<';
+  if (quoted)
+    p++;
+  uint8_t len = 0;
+  while (quoted ? (*p && *p != '>')
+                : ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))) {
+    if (len == 7)
+      return NULL;
+    name[len++] = *p++;
+  }
+  name[len] = '\0';
+  if (quoted && *p++ != '>')
+    return NULL;
+  return len >= 3 ? p : NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Parse a signed time, `[+|-]hh[:mm[:ss]]`.
+    @param p String to parse
+    @param[out] seconds Receives the time in seconds
+    @return Pointer past the time, or NULL if it is invalid.
+*/
+/**************************************************************************/
+const char *TimeZone::parseOffset(const char *p, int32_t &seconds) {
+  bool negative = *p == '-';
+  if (*p == '-' || *p == '+')
+    p++;
+  int32_t value = 0;
+  for (uint8_t field = 0; field < 3; field++) {
+    if (field && *p++ != ':')
+      return NULL;
+    if (*p < '0' || *p > '9')
+      return NULL;
+    uint8_t n = *p++ - '0';
+    if (*p >= '0' && *p <= '9')
+      n = n * 10 + *p++ - '0';
+    if (field ? n > 59 : n > 167)
+      return NULL;
+    value = value * 60 + n;
+    if (*p != ':') {
+      while (++field < 3)
+        value *= 60;
+      break;
+    }
+  }
+  seconds = negative ? -value : value;
+  return p;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Parse a transition rule: `Mm.w.d`, `Jn` or `n`, optionally
+            followed by `/time`.
+    @param p String to parse, pointing past the comma
+    @param[out] rule Receives the rule
+    @return Pointer past the rule, or NULL if it is invalid.
+*/
+/**************************************************************************/
+const char *TimeZone::parseRule(const char *p, Rule &rule) {
+  rule.type = *p == 'M' || *p == 'J' ? *p++ : 'n';
+  uint16_t fields[3] = {0, 0, 0};
+  uint8_t count = rule.type == 'M' ? 3 : 1;
+  for (uint8_t i = 0; i < count; i++) {
+    if (i && *p++ != '.')
+      return NULL;
+    if (*p < '0' || *p > '9')
+      return NULL;
+    while (*p >= '0' && *p <= '9' && fields[i] < 1000)
+      fields[i] = fields[i] * 10 + *p++ - '0';
+  }
+  if (rule.type == 'M') {
+    if (fields[0] < 1 || fields[0] > 12 || fields[1] < 1 || fields[1] > 5 ||
+        fields[2] > 6)
+      return NULL;
+    rule.month = fields[0];
+    rule.week = fields[1];
+    rule.wday = fields[2];
+  } else if (rule.type == 'J' ? fields[0] < 1 || fields[0] > 365
+                              : fields[0] > 365) {
+    return NULL;
+  }
+  rule.day = fields[0];
+  rule.time = 7200; // 02:00:00 by default
+  if (*p == '/')
+    p = parseOffset(p + 1, rule.time);
+  return p;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Parse a POSIX `TZ` string.
+
+    The format is `std offset [dst [offset] [,start[/time],end[/time]]]`.
+    The DST offset defaults to one hour ahead of standard time, and the
+    rules default to the US ones (`M3.2.0,M11.1.0`).
+
+    @param tz Rules, e.g. `"CET-1CEST,M3.5.0,M10.5.0/3"` or `"JST-9"`
+    @return True if `tz` is valid. Otherwise the zone is left unchanged.
+*/
+/**************************************************************************/
+bool TimeZone::begin(const char *tz) {
+  TimeZone zone;
+  const char *p = parseName(tz, zone.stdName);
+  if (p)
+    p = parseOffset(p, zone.stdOffset);
+  if (!p)
+    return false;
+  zone.stdOffset = -zone.stdOffset;
+  zone.dstOffset = zone.stdOffset;
+  if (*p) {
+    p = parseName(p, zone.dstName);
+    if (!p)
+      return false;
+    zone.dstOffset = zone.stdOffset + 3600;
+    if (*p && *p != ',') {
+      p = parseOffset(p, zone.dstOffset);
+      if (!p)
+        return false;
+      zone.dstOffset = -zone.dstOffset;
+    }
+    if (*p) {
+      if (*p++ != ',' || !(p = parseRule(p, zone.dstStart)) || *p++ != ',' ||
+          !(p = parseRule(p, zone.dstEnd)) || *p)
+        return false;
+    } else {
+      parseRule("M3.2.0", zone.dstStart);
+      parseRule("M11.1.0", zone.dstEnd);
+    }
+  }
+  *this = zone;
+  return true;
+}
+
+/** Day of the year of the first of each month, in a common year */
+static PROGMEM const uint16_t monthStart[] = {0,   31,  59,  90,  120, 151,
+                                              181, 212, 243, 273, 304, 334};
+
+/**************************************************************************/
+/*!
+    @brief  Compute the day of the year on which a rule applies.
+    @param rule The transition rule
+    @param year Full year
+    @param leap Whether `year` is a leap year
+    @return Day of the year, starting from 0 for 1 January.
+*/
+/**************************************************************************/
+uint16_t TimeZone::ruleDay(const Rule &rule, uint16_t year, bool leap) {
+  if (rule.type == 'J')
+    return rule.day - 1 + (leap && rule.day >= 60);
+  if (rule.type == 'n')
+    return rule.day;
+  uint8_t m = rule.month;
+  uint16_t start = pgm_read_word(&monthStart[m - 1]) + (leap && m > 2);
+  uint8_t length = m == 2 ? 28 + leap : 30 + ((m + (m >> 3)) & 1);
+  uint8_t first = DateTime(year, m, 1).dayOfTheWeek();
+  uint8_t day = (rule.wday + 7 - first) % 7 + (rule.week - 1) * 7;
+  if (day >= length)
+    day -= 7;
+  return start + day;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Compute the DST transitions of the year containing a time,
+            unless they are already cached.
+    @param t Unix time
+    @return True if the time falls within DST.
+*/
+/**************************************************************************/
+bool TimeZone::cacheYear(uint32_t t) {
+  if (!dstName[0])
+    return false;
+  if (t < yearStart || t >= yearEnd) {
+    uint16_t year = DateTime(t).year();
+    bool leap = year % 4 == 0;
+    yearStart = DateTime(year, 1, 1).unixtime();
+    yearEnd = yearStart + (leap ? 366 : 365) * 86400UL;
+    startInstant = yearStart + ruleDay(dstStart, year, leap) * 86400L +
+                   dstStart.time - stdOffset;
+    endInstant = yearStart + ruleDay(dstEnd, year, leap) * 86400L +
+                 dstEnd.time - dstOffset;
+  }
+  if (startInstant < endInstant) // northern hemisphere
+    return t >= startInstant && t < endInstant;
+  return t >= startInstant || t < endInstant;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check whether DST is in effect.
+    @param utc Date and time in UTC
+    @return True if DST is in effect at that time.
+*/
+/**************************************************************************/
+bool TimeZone::isDST(const DateTime &utc) {
+  return cacheYear(utc.unixtime());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the UTC offset in effect.
+    @param utc Date and time in UTC
+    @return Offset of local time from UTC in minutes, east positive. This
+        is the `offset` expected by `DateTime::timestamp()`.
+*/
+/**************************************************************************/
+int16_t TimeZone::offset(const DateTime &utc) {
+  return (isDST(utc) ? dstOffset : stdOffset) / 60;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the abbreviation of the local time in effect.
+    @param utc Date and time in UTC
+    @return Abbreviation, e.g. "CET" or "CEST".
+*/
+/**************************************************************************/
+const char *TimeZone::abbreviation(const DateTime &utc) {
+  return isDST(utc) ? dstName : stdName;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert UTC to local time.
+    @param utc Date and time in UTC
+    @return Local date and time.
+*/
+/**************************************************************************/
+DateTime TimeZone::toLocal(const DateTime &utc) {
+  uint32_t t = utc.unixtime();
+  return DateTime(t + (cacheYear(t) ? dstOffset : stdOffset));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert local time to UTC.
+
+    A local time repeated when DST ends is taken as DST. A local time
+    skipped when DST starts is taken as standard time, which gives a UTC
+    time within DST.
+
+    @param local Local date and time
+    @return Date and time in UTC.
+*/
+/**************************************************************************/
+DateTime TimeZone::toUTC(const DateTime &local) {
+  uint32_t t = local.unixtime();
+  if (cacheYear(t - dstOffset))
+    return DateTime(t - dstOffset);
+  return DateTime(t - stdOffset);
+}